@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*! \brief CPU-only stand-in for the TextureShareVk server and client
+ *
+ * Mirrors the subset of the client API used by TsvSender and TsvReceiveTexture (init_image, find_image, send_image,
+ * recv_image). Images live in host memory and copies are done with memcpy, so the benchmark runs without a GPU. This is
+ * a model of the server, it doesn't cross a process boundary and has no fences, so neither the cost of the server round
+ * trips nor leaks of VkFences or RenderingServer textures are represented.
+ */
+namespace stand_in
+{
+	enum class ImageLookupResult
+	{
+		Error,
+		NotFound,
+		Found,
+		RequiresUpdate,
+	};
+
+	/*! \brief Local texture, equivalent to a RenderingServer texture with its native handle
+	 */
+	struct Texture
+	{
+		Texture(uint32_t width, uint32_t height, uint32_t pixel_size)
+			: width(width), height(height), data((size_t)width * height * pixel_size)
+		{}
+
+		uint32_t             width;
+		uint32_t             height;
+		std::vector<uint8_t> data;
+	};
+
+	class Server
+	{
+		public:
+		struct Image
+		{
+			uint32_t             width      = 0;
+			uint32_t             height     = 0;
+			uint32_t             pixel_size = 0;
+			uint64_t             generation = 0;
+			std::vector<uint8_t> data;
+			std::mutex           data_mutex;
+		};
+
+		std::shared_ptr<Image> init_image(const std::string &name, uint32_t width, uint32_t height,
+		                                  uint32_t pixel_size)
+		{
+			auto image        = std::make_shared<Image>();
+			image->width      = width;
+			image->height     = height;
+			image->pixel_size = pixel_size;
+			image->data.resize((size_t)width * height * pixel_size);
+
+			std::lock_guard<std::mutex> lock(this->_mutex);
+			auto                       &entry = this->_images[name];
+			image->generation                 = entry ? entry->generation + 1 : 1;
+			entry                             = image;
+
+			return image;
+		}
+
+		std::shared_ptr<Image> find_image(const std::string &name)
+		{
+			std::lock_guard<std::mutex> lock(this->_mutex);
+			const auto                  image_it = this->_images.find(name);
+			return image_it != this->_images.end() ? image_it->second : nullptr;
+		}
+
+		private:
+		std::mutex                                    _mutex;
+		std::map<std::string, std::shared_ptr<Image>> _images;
+	};
+
+	class Client
+	{
+		public:
+		explicit Client(Server &server) : _server(server) {}
+
+		bool init_image(const char *image_name, uint32_t width, uint32_t height, uint32_t pixel_size)
+		{
+			this->_images[image_name] = this->_server.init_image(image_name, width, height, pixel_size);
+			return true;
+		}
+
+		ImageLookupResult find_image(const char *image_name, bool force_update)
+		{
+			std::shared_ptr<Server::Image> image = this->_server.find_image(image_name);
+			if(!image)
+			{
+				this->_images.erase(image_name);
+				return ImageLookupResult::NotFound;
+			}
+
+			auto &local = this->_images[image_name];
+			if(local == image)
+				return ImageLookupResult::Found;
+
+			if(!force_update)
+				return ImageLookupResult::RequiresUpdate;
+
+			local = image;
+			return ImageLookupResult::Found;
+		}
+
+		const Server::Image *find_image_data(const char *image_name) { return this->_get_image(image_name); }
+
+		bool send_image(const char *image_name, const Texture &texture)
+		{
+			Server::Image *const image = this->_get_image(image_name);
+			if(!image || image->data.size() != texture.data.size())
+				return false;
+
+			std::lock_guard<std::mutex> lock(image->data_mutex);
+			std::memcpy(image->data.data(), texture.data.data(), texture.data.size());
+			return true;
+		}
+
+		bool recv_image(const char *image_name, Texture &texture)
+		{
+			Server::Image *const image = this->_get_image(image_name);
+			if(!image || image->data.size() != texture.data.size())
+				return false;
+
+			std::lock_guard<std::mutex> lock(image->data_mutex);
+			std::memcpy(texture.data.data(), image->data.data(), texture.data.size());
+			return true;
+		}
+
+		private:
+		Server                                               &_server;
+		std::map<std::string, std::shared_ptr<Server::Image>> _images;
+
+		Server::Image *_get_image(const std::string &image_name)
+		{
+			const auto image_it = this->_images.find(image_name);
+			return image_it != this->_images.end() ? image_it->second.get() : nullptr;
+		}
+	};
+} // namespace stand_in
@@ -0,0 +1,177 @@
+/*! \brief Unit tests for TransferScheduler
+ *
+ * Checks round-robin deferral, forced grants, and the release of reserved bytes. Runs without Godot.
+ */
+
+#include "transfer_scheduler.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+	int failures = 0;
+
+#define CHECK(condition)                                                                                               \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		if(!(condition))                                                                                               \
+		{                                                                                                              \
+			std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);                         \
+			++failures;                                                                                                \
+		}                                                                                                              \
+	} while(false)
+
+	void test_round_robin()
+	{
+		// Budget fits one of three equal channels per frame
+		TransferScheduler scheduler;
+		scheduler.set_frame_byte_budget(100);
+		const TransferScheduler::channel_id_t ids[3] = {
+			scheduler.add_channel(),
+			scheduler.add_channel(),
+			scheduler.add_channel(),
+		};
+
+		std::string grants;
+		for(uint64_t frame = 0; frame < 6; ++frame)
+		{
+			for(size_t i = 0; i < 3; ++i)
+			{
+				if(scheduler.request_transfer(ids[i], frame, 100))
+					grants += (char)('A' + i);
+			}
+		}
+
+		CHECK(grants == "ABCABC");
+	}
+
+	void test_priority()
+	{
+		TransferScheduler scheduler;
+		scheduler.set_frame_byte_budget(100);
+		const TransferScheduler::channel_id_t low  = scheduler.add_channel(0);
+		const TransferScheduler::channel_id_t high = scheduler.add_channel(1);
+
+		// Unplanned first frame is granted in request order, afterwards the higher priority is planned first
+		CHECK(scheduler.request_transfer(low, 0, 100));
+		CHECK(!scheduler.request_transfer(high, 0, 100));
+		for(uint64_t frame = 1; frame < 4; ++frame)
+		{
+			CHECK(!scheduler.request_transfer(low, frame, 100));
+			CHECK(scheduler.request_transfer(high, frame, 100));
+		}
+	}
+
+	void test_forced_grant()
+	{
+		// Low priority channel is starved by the high priority one until it hits max_deferred_frames
+		TransferScheduler scheduler;
+		scheduler.set_frame_byte_budget(100);
+		const TransferScheduler::channel_id_t high = scheduler.add_channel(1);
+		const TransferScheduler::channel_id_t low  = scheduler.add_channel(0, 2);
+
+		std::vector<uint64_t> low_grants;
+		for(uint64_t frame = 0; frame < 9; ++frame)
+		{
+			scheduler.request_transfer(high, frame, 100);
+			if(scheduler.request_transfer(low, frame, 100))
+				low_grants.push_back(frame);
+		}
+
+		CHECK((low_grants == std::vector<uint64_t>{2, 5, 8}));
+
+		// Transfers larger than the budget are only granted once forced
+		TransferScheduler oversized;
+		oversized.set_frame_byte_budget(50);
+		const TransferScheduler::channel_id_t id = oversized.add_channel(0, 1);
+
+		CHECK(!oversized.request_transfer(id, 0, 100));
+		CHECK(oversized.request_transfer(id, 1, 100));
+		CHECK(!oversized.request_transfer(id, 2, 100));
+		CHECK(oversized.get_last_frame_stats().frame == 1);
+		CHECK(oversized.get_last_frame_stats().forced_count == 1);
+		CHECK(oversized.get_last_frame_stats().granted_bytes == 100);
+	}
+
+	void test_remove_channel_releases_reservation()
+	{
+		TransferScheduler scheduler;
+		scheduler.set_frame_byte_budget(100);
+		const TransferScheduler::channel_id_t a = scheduler.add_channel();
+		const TransferScheduler::channel_id_t b = scheduler.add_channel();
+
+		CHECK(scheduler.request_transfer(a, 0, 100));
+		CHECK(!scheduler.request_transfer(b, 0, 100));
+
+		// b is planned for frame 1. Removing it returns its reservation to unplanned channels
+		CHECK(!scheduler.request_transfer(a, 1, 100));
+		scheduler.remove_channel(b);
+		CHECK(scheduler.get_channel_count() == 1);
+
+		const TransferScheduler::channel_id_t c = scheduler.add_channel();
+		CHECK(scheduler.request_transfer(c, 1, 100));
+	}
+
+	void test_missed_turn_releases_reservation()
+	{
+		TransferScheduler scheduler;
+		scheduler.set_frame_byte_budget(100);
+		const TransferScheduler::channel_id_t a = scheduler.add_channel();
+		const TransferScheduler::channel_id_t b = scheduler.add_channel();
+		const TransferScheduler::channel_id_t c = scheduler.add_channel();
+
+		CHECK(scheduler.request_transfer(a, 0, 100));
+		CHECK(!scheduler.request_transfer(b, 0, 100));
+		CHECK(!scheduler.request_transfer(c, 0, 100));
+
+		// b is planned for frame 1, but stops requesting. Once c, which requested after b, asks, b's turn has passed
+		CHECK(!scheduler.request_transfer(a, 1, 100));
+		CHECK(scheduler.request_transfer(c, 1, 100));
+
+		// New channels don't release reservations of planned channels
+		TransferScheduler ordered;
+		ordered.set_frame_byte_budget(100);
+		const TransferScheduler::channel_id_t d = ordered.add_channel();
+		const TransferScheduler::channel_id_t e = ordered.add_channel();
+
+		CHECK(ordered.request_transfer(d, 0, 100));
+		CHECK(!ordered.request_transfer(e, 0, 100));
+
+		const TransferScheduler::channel_id_t f = ordered.add_channel();
+		CHECK(!ordered.request_transfer(f, 1, 100));
+		CHECK(ordered.request_transfer(e, 1, 100));
+	}
+
+	void test_no_budget()
+	{
+		TransferScheduler                     scheduler;
+		const TransferScheduler::channel_id_t id = scheduler.add_channel();
+		for(uint64_t frame = 0; frame < 3; ++frame)
+			CHECK(scheduler.request_transfer(id, frame, UINT64_MAX));
+
+		// Unknown channels are never deferred
+		scheduler.set_frame_byte_budget(1);
+		CHECK(scheduler.request_transfer(id + 1, 3, 100));
+	}
+} // namespace
+
+int main()
+{
+	test_round_robin();
+	test_priority();
+	test_forced_grant();
+	test_remove_channel_releases_reservation();
+	test_missed_turn_releases_reservation();
+	test_no_budget();
+
+	if(failures > 0)
+	{
+		std::fprintf(stderr, "%d check(s) failed\n", failures);
+		return 1;
+	}
+
+	std::printf("All checks passed\n");
+	return 0;
+}
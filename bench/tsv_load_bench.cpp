@@ -0,0 +1,407 @@
+/*! \brief Multi-channel scaling and soak benchmark for TransferScheduler
+ *
+ * Drives N sender/receiver channel pairs against a local stand-in server, following the same per-frame steps as
+ * TsvSender and TsvReceiveTexture (lookup, resize, transfer admission, receive). Runs without a GPU or Godot.
+ *
+ * TransferScheduler is the only code of the extension that runs here, the sender and receiver steps and the server
+ * are models. scheduler_p50/p99 is the per-frame time spent in TransferScheduler. model_frame_p50/p99 and throughput
+ * are dominated by host memcpy of the stand-in, and neither reflect GPU copies nor the extension's server round trips.
+ * Leaks of the extension's fences and textures can't be detected without Godot, so none are reported.
+ *
+ * Usage: tsv_load_bench [--channels 1,8,64,256] [--frames 600] [--duration <sec>] [--resize-interval 120]
+ *                       [--max-width 1280] [--max-height 720] [--budget <bytes>] [--report-interval <sec>]
+ */
+
+#include "stand_in_server.hpp"
+#include "transfer_scheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+	using bench_clock = std::chrono::steady_clock;
+
+	constexpr uint32_t PIXEL_SIZE = 4;
+
+	struct Resolution
+	{
+		uint32_t width;
+		uint32_t height;
+	};
+
+	constexpr Resolution RESOLUTIONS[] = {
+		{64,   64  },
+		{320,  240 },
+		{640,  360 },
+		{1280, 720 },
+		{1920, 1080},
+	};
+
+	struct Options
+	{
+		std::vector<uint32_t> channels        = {1, 8, 64, 256};
+		uint64_t              frames          = 600;
+		double                duration        = 0.0;
+		uint64_t              resize_interval = 120;
+		uint32_t              max_width       = 1280;
+		uint32_t              max_height      = 720;
+		uint64_t              budget          = 0;
+		double                report_interval = 0.0;
+	};
+
+	struct Sender
+	{
+		Sender(stand_in::Server &server, std::string name) : name(std::move(name)), client(server) {}
+
+		std::string                        name;
+		stand_in::Client                   client;
+		std::unique_ptr<stand_in::Texture> texture;
+		TransferScheduler::channel_id_t    channel = 0;
+	};
+
+	struct Receiver
+	{
+		Receiver(stand_in::Server &server, std::string name) : name(std::move(name)), client(server) {}
+
+		std::string                        name;
+		stand_in::Client                   client;
+		std::unique_ptr<stand_in::Texture> texture;
+		TransferScheduler::channel_id_t    channel = 0;
+	};
+
+	struct FrameCounters
+	{
+		uint64_t bytes    = 0;
+		uint64_t copies   = 0;
+		uint64_t deferred = 0;
+		uint64_t failed   = 0;
+		uint64_t resizes  = 0;
+
+		// Time spent in TransferScheduler::request_transfer
+		double scheduler_ms = 0.0;
+	};
+
+	uint64_t get_rss_bytes()
+	{
+		FILE *statm = std::fopen("/proc/self/statm", "r");
+		if(!statm)
+			return 0;
+
+		unsigned long size = 0, resident = 0;
+		if(std::fscanf(statm, "%lu %lu", &size, &resident) != 2)
+			resident = 0;
+
+		std::fclose(statm);
+		return (uint64_t)resident * (uint64_t)sysconf(_SC_PAGESIZE);
+	}
+
+	/*! \brief Frame time histogram with 100000 buckets of bucket_ms. Allocated once, so that long soak runs don't add
+	 * to the measured memory growth
+	 */
+	class FrameTimeHistogram
+	{
+		public:
+		explicit FrameTimeHistogram(double bucket_ms) : _bucket_ms(bucket_ms), _buckets(BUCKET_COUNT, 0) {}
+
+		void add(double ms)
+		{
+			const size_t bucket = std::min(BUCKET_COUNT - 1, (size_t)(ms / this->_bucket_ms));
+			this->_buckets[bucket] += 1;
+			this->_count += 1;
+		}
+
+		double percentile(double p) const
+		{
+			const uint64_t target = (uint64_t)(p * (double)this->_count);
+			uint64_t       seen   = 0;
+			for(size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket)
+			{
+				seen += this->_buckets[bucket];
+				if(seen > target)
+					return (double)(bucket + 1) * this->_bucket_ms;
+			}
+
+			return (double)BUCKET_COUNT * this->_bucket_ms;
+		}
+
+		uint64_t count() const { return this->_count; }
+
+		void clear()
+		{
+			std::fill(this->_buckets.begin(), this->_buckets.end(), 0);
+			this->_count = 0;
+		}
+
+		private:
+		static constexpr size_t BUCKET_COUNT = 100000;
+
+		double                _bucket_ms;
+		std::vector<uint64_t> _buckets;
+		uint64_t              _count = 0;
+	};
+
+	std::vector<Resolution> get_resolutions(const Options &options)
+	{
+		std::vector<Resolution> resolutions;
+		for(const Resolution &res : RESOLUTIONS)
+		{
+			if(res.width <= options.max_width && res.height <= options.max_height)
+				resolutions.push_back(res);
+		}
+
+		if(resolutions.empty())
+			resolutions.push_back({options.max_width, options.max_height});
+
+		return resolutions;
+	}
+
+	void resize_sender(Sender &sender, const Resolution &res, FrameCounters &counters)
+	{
+		sender.texture = std::make_unique<stand_in::Texture>(res.width, res.height, PIXEL_SIZE);
+		sender.client.init_image(sender.name.c_str(), res.width, res.height, PIXEL_SIZE);
+		counters.resizes += 1;
+	}
+
+	bool request_transfer(TransferScheduler &scheduler, TransferScheduler::channel_id_t channel, uint64_t frame,
+	                      uint64_t bytes, FrameCounters &counters)
+	{
+		const auto start   = bench_clock::now();
+		const bool granted = scheduler.request_transfer(channel, frame, bytes);
+		counters.scheduler_ms += std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+
+		return granted;
+	}
+
+	void send(Sender &sender, TransferScheduler &scheduler, uint64_t frame, FrameCounters &counters)
+	{
+		const uint64_t bytes = sender.texture->data.size();
+		if(!request_transfer(scheduler, sender.channel, frame, bytes, counters))
+		{
+			counters.deferred += 1;
+			return;
+		}
+
+		// Stamp the frame, so content changes between sends
+		std::memcpy(sender.texture->data.data(), &frame, std::min(sizeof(frame), sender.texture->data.size()));
+
+		if(sender.client.send_image(sender.name.c_str(), *sender.texture))
+		{
+			counters.bytes += bytes;
+			counters.copies += 1;
+		}
+		else
+			counters.failed += 1;
+	}
+
+	void receive(Receiver &receiver, TransferScheduler &scheduler, uint64_t frame, FrameCounters &counters)
+	{
+		using stand_in::ImageLookupResult;
+
+		ImageLookupResult res = receiver.client.find_image(receiver.name.c_str(), false);
+		if(res == ImageLookupResult::NotFound || res == ImageLookupResult::Error)
+			return;
+
+		if(res == ImageLookupResult::RequiresUpdate || !receiver.texture)
+		{
+			res = receiver.client.find_image(receiver.name.c_str(), true);
+			if(res != ImageLookupResult::Found)
+				return;
+
+			const stand_in::Server::Image *const data = receiver.client.find_image_data(receiver.name.c_str());
+			receiver.texture = std::make_unique<stand_in::Texture>(data->width, data->height, PIXEL_SIZE);
+		}
+
+		const uint64_t bytes = receiver.texture->data.size();
+		if(!request_transfer(scheduler, receiver.channel, frame, bytes, counters))
+		{
+			counters.deferred += 1;
+			return;
+		}
+
+		if(receiver.client.recv_image(receiver.name.c_str(), *receiver.texture))
+		{
+			counters.bytes += bytes;
+			counters.copies += 1;
+		}
+		else
+			counters.failed += 1;
+	}
+
+	void run(const Options &options, uint32_t channel_count)
+	{
+		const std::vector<Resolution> resolutions = get_resolutions(options);
+		const uint64_t                rss_before  = get_rss_bytes();
+
+		stand_in::Server  server;
+		TransferScheduler scheduler;
+		scheduler.set_frame_byte_budget(options.budget);
+
+		FrameCounters total;
+
+		std::vector<std::unique_ptr<Sender>>   senders;
+		std::vector<std::unique_ptr<Receiver>> receivers;
+		for(uint32_t i = 0; i < channel_count; ++i)
+		{
+			const std::string name = "bench_channel_" + std::to_string(i);
+
+			senders.push_back(std::make_unique<Sender>(server, name));
+			senders.back()->channel = scheduler.add_channel(i % 3, 8);
+			resize_sender(*senders.back(), resolutions[i % resolutions.size()], total);
+
+			receivers.push_back(std::make_unique<Receiver>(server, name));
+			receivers.back()->channel = scheduler.add_channel(i % 3, 8);
+		}
+
+		// Model frames take milliseconds, scheduling takes microseconds
+		FrameTimeHistogram frame_times(0.01);
+		FrameTimeHistogram window_times(0.01);
+		FrameTimeHistogram scheduler_times(0.0001);
+		FrameTimeHistogram window_scheduler_times(0.0001);
+		const auto         start       = bench_clock::now();
+		auto               last_report = start;
+		FrameCounters      window;
+
+		// Memory drift is measured after all channels went through one resize cycle
+		const uint64_t warmup_frames = std::max<uint64_t>(options.resize_interval, 1);
+		uint64_t       rss_warmup    = 0;
+
+		for(uint64_t frame = 0;; ++frame)
+		{
+			const double elapsed = std::chrono::duration<double>(bench_clock::now() - start).count();
+			if(options.duration > 0.0 ? elapsed >= options.duration : frame >= options.frames)
+				break;
+
+			const auto frame_start = bench_clock::now();
+
+			FrameCounters counters;
+			for(uint32_t i = 0; i < channel_count; ++i)
+			{
+				// Spread resizes over frames, so not all channels reallocate at once
+				if(options.resize_interval > 0 && frame > 0 && (frame + i) % options.resize_interval == 0)
+				{
+					const size_t res_index = (i + frame / options.resize_interval) % resolutions.size();
+					resize_sender(*senders[i], resolutions[res_index], counters);
+				}
+
+				send(*senders[i], scheduler, frame, counters);
+			}
+
+			for(uint32_t i = 0; i < channel_count; ++i)
+				receive(*receivers[i], scheduler, frame, counters);
+
+			const double frame_ms = std::chrono::duration<double, std::milli>(bench_clock::now() - frame_start).count();
+			frame_times.add(frame_ms);
+			window_times.add(frame_ms);
+			scheduler_times.add(counters.scheduler_ms);
+			window_scheduler_times.add(counters.scheduler_ms);
+
+			if(frame + 1 == warmup_frames)
+				rss_warmup = get_rss_bytes();
+
+			for(FrameCounters *c : {&total, &window})
+			{
+				c->bytes += counters.bytes;
+				c->copies += counters.copies;
+				c->deferred += counters.deferred;
+				c->failed += counters.failed;
+				c->resizes += counters.resizes;
+			}
+
+			const auto now = bench_clock::now();
+			if(options.report_interval > 0.0 &&
+			   std::chrono::duration<double>(now - last_report).count() >= options.report_interval)
+			{
+				const double window_sec = std::chrono::duration<double>(now - last_report).count();
+				std::printf("  [%8.1fs] channels=%u frame=%lu scheduler_p50=%.4fms scheduler_p99=%.4fms "
+				            "model_frame_p50=%.3fms model_frame_p99=%.3fms model_throughput=%.1fMB/s rss=%.1fMB\n",
+				            std::chrono::duration<double>(now - start).count(), channel_count, (unsigned long)frame,
+				            window_scheduler_times.percentile(0.5), window_scheduler_times.percentile(0.99),
+				            window_times.percentile(0.5), window_times.percentile(0.99),
+				            (double)window.bytes / window_sec / 1e6, (double)get_rss_bytes() / 1e6);
+
+				window_times.clear();
+				window_scheduler_times.clear();
+				window      = FrameCounters();
+				last_report = now;
+			}
+		}
+
+		const double   total_sec  = std::chrono::duration<double>(bench_clock::now() - start).count();
+		const uint64_t rss_end    = get_rss_bytes();
+		const double   rss_growth = ((double)rss_end - (double)rss_before) / 1e6;
+		const double   rss_drift  = rss_warmup > 0 ? ((double)rss_end - (double)rss_warmup) / 1e6 : 0.0;
+		std::printf("channels=%-4u frames=%-7lu scheduler_p50=%.4fms scheduler_p99=%.4fms model_frame_p50=%.3fms "
+		            "model_frame_p99=%.3fms model_throughput=%.1fMB/s copies=%lu deferred=%lu failed=%lu resizes=%lu "
+		            "rss_growth=%.1fMB rss_drift=%.1fMB\n",
+		            channel_count, (unsigned long)frame_times.count(), scheduler_times.percentile(0.5),
+		            scheduler_times.percentile(0.99), frame_times.percentile(0.5), frame_times.percentile(0.99),
+		            (double)total.bytes / std::max(total_sec, 1e-9) / 1e6, (unsigned long)total.copies,
+		            (unsigned long)total.deferred, (unsigned long)total.failed, (unsigned long)total.resizes, rss_growth,
+		            rss_drift);
+	}
+
+	bool parse_options(int argc, char **argv, Options &options)
+	{
+		for(int i = 1; i < argc; ++i)
+		{
+			const std::string arg = argv[i];
+			if(i + 1 >= argc)
+			{
+				std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+				return false;
+			}
+
+			const char *const value = argv[++i];
+			if(arg == "--channels")
+			{
+				options.channels.clear();
+				std::stringstream stream(value);
+				std::string       count;
+				while(std::getline(stream, count, ','))
+					options.channels.push_back((uint32_t)std::stoul(count));
+			}
+			else if(arg == "--frames")
+				options.frames = std::stoull(value);
+			else if(arg == "--duration")
+				options.duration = std::stod(value);
+			else if(arg == "--resize-interval")
+				options.resize_interval = std::stoull(value);
+			else if(arg == "--max-width")
+				options.max_width = (uint32_t)std::stoul(value);
+			else if(arg == "--max-height")
+				options.max_height = (uint32_t)std::stoul(value);
+			else if(arg == "--budget")
+				options.budget = std::stoull(value);
+			else if(arg == "--report-interval")
+				options.report_interval = std::stod(value);
+			else
+			{
+				std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+				return false;
+			}
+		}
+
+		return true;
+	}
+} // namespace
+
+int main(int argc, char **argv)
+{
+	Options options;
+	if(!parse_options(argc, argv, options))
+		return EXIT_FAILURE;
+
+	for(const uint32_t channel_count : options.channels)
+		run(options, channel_count);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <godot_cpp/variant/rect2i.hpp>
+
+#include <algorithm>
+
+/*! \brief Clamp a crop rectangle to an image of size width x height. An empty rectangle, or one that lies entirely
+ * outside of the image, selects the entire image
+ */
+inline godot::Rect2i clamp_copy_region(const godot::Rect2i &crop, int32_t width, int32_t height)
+{
+	const godot::Rect2i image(0, 0, width, height);
+	if(crop.size.x <= 0 || crop.size.y <= 0)
+		return image;
+
+	// A 0x0 region would create an invalid shared image. The texture may also shrink after the crop was set
+	const godot::Rect2i region = image.intersection(crop);
+	if(region.size.x <= 0 || region.size.y <= 0)
+		return image;
+
+	return region;
+}
+
+/*! \brief Corners {x0, y0, x1, y1} of the blit region. Flipping is done by swapping corners, which both
+ * vkCmdBlitImage and glBlitFramebuffer support
+ */
+inline void get_copy_corners(const godot::Rect2i &region, bool flip_h, bool flip_v, int32_t corners[4])
+{
+	corners[0] = region.position.x;
+	corners[1] = region.position.y;
+	corners[2] = region.position.x + region.size.x;
+	corners[3] = region.position.y + region.size.y;
+
+	if(flip_h)
+		std::swap(corners[0], corners[2]);
+	if(flip_v)
+		std::swap(corners[1], corners[3]);
+}
@@ -34,6 +34,19 @@ inline godot::Image::Format convert_rendering_device_to_godot_format(tsv_image_f
 	}
 }
 
+inline uint32_t get_godot_format_pixel_size(godot::Image::Format format)
+{
+	switch(format)
+	{
+	    case godot::Image::Format::FORMAT_RGBA8:
+		    return 4;
+	    case godot::Image::Format::FORMAT_RGB8:
+		    return 3;
+	    default:
+		    return 0;
+	}
+}
+
 //inline texture_format_t convert_godot_to_rendering_device_format(godot::Image::Format format)
 //{
 //#ifdef USE_OPENGL
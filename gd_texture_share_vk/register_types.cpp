@@ -1,28 +1,52 @@
 #include "register_types.hpp"
 
+#include "tsv_channel_registry.hpp"
 #include "tsv_receive_texture.hpp"
 #include "tsv_sender.hpp"
+#include "tsv_transfer_scheduler.hpp"
+#include "tsv_viewport_sender.hpp"
 
 #include <gdextension_interface.h>
+#include <godot_cpp/classes/engine.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/core/defs.hpp>
 #include <godot_cpp/godot.hpp>
 
 using namespace godot;
 
+static TsvChannelRegistry   *tsv_channel_registry   = nullptr;
+static TsvTransferScheduler *tsv_transfer_scheduler = nullptr;
+
 void initialize_module(ModuleInitializationLevel p_level)
 {
 	if(p_level != MODULE_INITIALIZATION_LEVEL_SCENE)
 		return;
 
+	ClassDB::register_class<TsvChannelRegistry>();
 	ClassDB::register_class<TsvReceiveTexture>();
 	ClassDB::register_class<TsvSender>();
+	ClassDB::register_class<TsvTransferScheduler>();
+	ClassDB::register_class<TsvViewportSender>();
+
+	tsv_channel_registry = memnew(TsvChannelRegistry);
+	Engine::get_singleton()->register_singleton("TsvChannelRegistry", tsv_channel_registry);
+
+	tsv_transfer_scheduler = memnew(TsvTransferScheduler);
+	Engine::get_singleton()->register_singleton("TsvTransferScheduler", tsv_transfer_scheduler);
 }
 
 void uninitialize_module(ModuleInitializationLevel p_level)
 {
 	if(p_level != MODULE_INITIALIZATION_LEVEL_SCENE)
 		return;
+
+	Engine::get_singleton()->unregister_singleton("TsvTransferScheduler");
+	memdelete(tsv_transfer_scheduler);
+	tsv_transfer_scheduler = nullptr;
+
+	Engine::get_singleton()->unregister_singleton("TsvChannelRegistry");
+	memdelete(tsv_channel_registry);
+	tsv_channel_registry = nullptr;
 }
 
 extern "C"
@@ -0,0 +1,175 @@
+#include "transfer_scheduler.hpp"
+
+#include <algorithm>
+
+TransferScheduler::channel_id_t TransferScheduler::add_channel(int32_t priority, uint32_t max_deferred_frames)
+{
+	const channel_id_t id = this->_next_id++;
+
+	Channel &channel            = this->_channels[id];
+	channel.priority            = priority;
+	channel.max_deferred_frames = max_deferred_frames;
+
+	return id;
+}
+
+void TransferScheduler::remove_channel(channel_id_t id)
+{
+	const auto channel_it = this->_channels.find(id);
+	if(channel_it == this->_channels.end())
+		return;
+
+	// Return reserved bytes
+	if(channel_it->second.planned)
+		this->_remaining_bytes += channel_it->second.planned_bytes;
+
+	std::erase_if(this->_plan_order, [id](const auto &entry) { return entry.first == id; });
+	this->_channels.erase(channel_it);
+}
+
+void TransferScheduler::set_channel_priority(channel_id_t id, int32_t priority)
+{
+	const auto channel_it = this->_channels.find(id);
+	if(channel_it != this->_channels.end())
+		channel_it->second.priority = priority;
+}
+
+void TransferScheduler::set_channel_max_deferred_frames(channel_id_t id, uint32_t max_deferred_frames)
+{
+	const auto channel_it = this->_channels.find(id);
+	if(channel_it != this->_channels.end())
+		channel_it->second.max_deferred_frames = max_deferred_frames;
+}
+
+bool TransferScheduler::request_transfer(channel_id_t id, uint64_t frame, uint64_t bytes)
+{
+	if(frame != this->_current_frame)
+		this->_begin_frame(frame);
+
+	const auto channel_it = this->_channels.find(id);
+	if(channel_it == this->_channels.end())
+		return true;
+
+	Channel &channel = channel_it->second;
+
+	// Planned channels that requested before this one in the previous frame, but not yet in this one, have missed their
+	// turn
+	if(channel.last_request_frame == this->_previous_frame && channel.request_index > this->_turn_index)
+	{
+		this->_turn_index = channel.request_index;
+		this->_release_missed_reservations(this->_turn_index);
+	}
+
+	bool granted = false;
+	bool forced  = false;
+	if(this->_frame_byte_budget == 0)
+		granted = true;
+	else
+	{
+		// Bytes reserved during planning are available to this channel
+		const uint64_t available = this->_remaining_bytes + (channel.planned ? channel.planned_bytes : 0);
+		if(bytes <= available)
+			granted = true;
+		else if(this->_is_forced(channel))
+			granted = forced = true;
+
+		if(granted)
+			this->_remaining_bytes = available - std::min(bytes, available);
+		else
+			this->_remaining_bytes = available;
+	}
+
+	channel.planned            = false;
+	channel.planned_bytes      = 0;
+	channel.bytes              = bytes;
+	channel.last_request_frame = frame;
+	channel.request_index      = this->_request_count++;
+
+	if(granted)
+	{
+		channel.deferred_frames  = 0;
+		channel.last_grant_frame = frame;
+
+		this->_current_frame_stats.granted_bytes += bytes;
+		this->_current_frame_stats.granted_count += 1;
+		this->_current_frame_stats.forced_count += forced ? 1 : 0;
+	}
+	else
+	{
+		channel.deferred_frames += 1;
+		this->_current_frame_stats.deferred_count += 1;
+	}
+
+	return granted;
+}
+
+void TransferScheduler::_begin_frame(uint64_t frame)
+{
+	const uint64_t previous_frame = this->_current_frame;
+	if(previous_frame != UINT64_MAX)
+		this->_last_frame_stats = this->_current_frame_stats;
+
+	this->_current_frame                    = frame;
+	this->_previous_frame                   = previous_frame;
+	this->_request_count                    = 0;
+	this->_turn_index                       = 0;
+	this->_current_frame_stats              = FrameStats();
+	this->_current_frame_stats.frame        = frame;
+	this->_current_frame_stats.budget_bytes = this->_frame_byte_budget;
+	this->_remaining_bytes                  = this->_frame_byte_budget;
+
+	// Plan grants for channels that were active in the previous frame
+	this->_plan_order.clear();
+	for(auto &[id, channel] : this->_channels)
+	{
+		channel.planned       = false;
+		channel.planned_bytes = 0;
+		if(channel.last_request_frame == previous_frame)
+			this->_plan_order.emplace_back(id, &channel);
+	}
+
+	if(this->_frame_byte_budget == 0)
+		return;
+
+	std::sort(this->_plan_order.begin(), this->_plan_order.end(), [this](const auto &a, const auto &b) {
+		const bool forced_a = this->_is_forced(*a.second);
+		const bool forced_b = this->_is_forced(*b.second);
+		if(forced_a != forced_b)
+			return forced_a;
+		if(a.second->priority != b.second->priority)
+			return a.second->priority > b.second->priority;
+		if(a.second->deferred_frames != b.second->deferred_frames)
+			return a.second->deferred_frames > b.second->deferred_frames;
+		if(a.second->last_grant_frame != b.second->last_grant_frame)
+			return a.second->last_grant_frame < b.second->last_grant_frame;
+		return a.first < b.first;
+	});
+
+	for(auto &[id, channel] : this->_plan_order)
+	{
+		if(channel->bytes > this->_remaining_bytes && !this->_is_forced(*channel))
+			continue;
+
+		channel->planned       = true;
+		channel->planned_bytes = std::min(channel->bytes, this->_remaining_bytes);
+		this->_remaining_bytes -= channel->planned_bytes;
+	}
+}
+
+void TransferScheduler::_release_missed_reservations(uint32_t turn_index)
+{
+	for(auto &[id, channel] : this->_plan_order)
+	{
+		if(!channel->planned || channel->request_index >= turn_index)
+			continue;
+
+		this->_remaining_bytes += channel->planned_bytes;
+		channel->planned       = false;
+		channel->planned_bytes = 0;
+	}
+}
+
+bool TransferScheduler::_is_forced(const Channel &channel) const
+{
+	return channel.max_deferred_frames > 0 && channel.deferred_frames >= channel.max_deferred_frames;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/*! \brief Distributes a per-frame byte budget across texture share channels
+ *
+ * Transfers are granted in order of priority. Channels of equal priority that were deferred for longer go first, so
+ * deferred transfers are handed out round-robin. A channel's minimum rate is given as the maximum number of frames it
+ * may be deferred in a row, after which it is granted regardless of the budget.
+ *
+ * Grants for a frame are planned once, using the channels and sizes requested in the previous frame. Channels that
+ * weren't planned for are granted if the remaining budget allows it. Channels are expected to request in roughly the
+ * same order every frame. Once a channel that requested after a planned channel in the previous frame requests, the
+ * planned channel has missed its turn and its reservation is released to the remaining budget.
+ *
+ * Not thread-safe, TsvTransferScheduler serializes access.
+ */
+class TransferScheduler
+{
+	public:
+	using channel_id_t = uint64_t;
+
+	struct FrameStats
+	{
+		uint64_t frame          = 0;
+		uint64_t budget_bytes   = 0;
+		uint64_t granted_bytes  = 0;
+		uint32_t granted_count  = 0;
+		uint32_t deferred_count = 0;
+		uint32_t forced_count   = 0;
+	};
+
+	/*! \brief Register a new channel
+	 * \param priority Channels with higher priority are granted first
+	 * \param max_deferred_frames Maximum number of consecutive frames the channel may be deferred. 0 means the channel
+	 * may be deferred indefinitely
+	 */
+	channel_id_t add_channel(int32_t priority = 0, uint32_t max_deferred_frames = 0);
+	void         remove_channel(channel_id_t id);
+
+	void set_channel_priority(channel_id_t id, int32_t priority);
+	void set_channel_max_deferred_frames(channel_id_t id, uint32_t max_deferred_frames);
+
+	/*! \brief Set the number of bytes that may be transferred per frame. 0 disables the budget
+	 */
+	void     set_frame_byte_budget(uint64_t budget) { this->_frame_byte_budget = budget; }
+	uint64_t get_frame_byte_budget() const { return this->_frame_byte_budget; }
+
+	/*! \brief Request a transfer of the given size for the given frame
+	 * \return Returns true if the transfer should be done this frame, false if it should be deferred
+	 */
+	bool request_transfer(channel_id_t id, uint64_t frame, uint64_t bytes);
+
+	/*! \brief Statistics of the last completed frame
+	 */
+	const FrameStats &get_last_frame_stats() const { return this->_last_frame_stats; }
+
+	size_t get_channel_count() const { return this->_channels.size(); }
+
+	private:
+	struct Channel
+	{
+		int32_t  priority            = 0;
+		uint32_t max_deferred_frames = 0;
+
+		uint64_t bytes           = 0;
+		uint32_t deferred_frames = 0;
+
+		uint64_t last_request_frame = UINT64_MAX;
+		uint64_t last_grant_frame   = 0;
+
+		// Position among the requests of last_request_frame
+		uint32_t request_index = 0;
+
+		uint64_t planned_bytes = 0;
+		bool     planned       = false;
+	};
+
+	std::map<channel_id_t, Channel> _channels;
+	channel_id_t                    _next_id = 1;
+
+	uint64_t _frame_byte_budget = 0;
+
+	uint64_t   _current_frame   = UINT64_MAX;
+	uint64_t   _previous_frame  = UINT64_MAX;
+	uint64_t   _remaining_bytes = 0;
+	uint32_t   _request_count   = 0;
+	uint32_t   _turn_index      = 0;
+	FrameStats _current_frame_stats;
+	FrameStats _last_frame_stats;
+
+	std::vector<std::pair<channel_id_t, Channel *>> _plan_order;
+
+	void _begin_frame(uint64_t frame);
+	void _release_missed_reservations(uint32_t turn_index);
+	bool _is_forced(const Channel &channel) const;
+};
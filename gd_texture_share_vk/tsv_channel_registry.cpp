@@ -0,0 +1,284 @@
+#include "tsv_channel_registry.hpp"
+
+#include "format_conversion.hpp"
+
+#include <assert.h>
+
+#include <godot_cpp/classes/rendering_device.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/core/error_macros.hpp>
+
+TsvChannelRegistry *TsvChannelRegistry::_singleton = nullptr;
+
+TsvChannelRegistry::TsvChannelRegistry()
+{
+	assert(_singleton == nullptr);
+	_singleton = this;
+}
+
+TsvChannelRegistry::~TsvChannelRegistry()
+{
+	if(_singleton == this)
+		_singleton = nullptr;
+}
+
+TsvChannelRegistry *TsvChannelRegistry::get_singleton()
+{
+	return _singleton;
+}
+
+godot::Array TsvChannelRegistry::get_channels() const
+{
+	godot::Array channels;
+	for(const auto &[name, info] : this->_channels)
+		channels.push_back(to_dictionary(name, info));
+
+	return channels;
+}
+
+godot::Dictionary TsvChannelRegistry::get_channel(const godot::String &name) const
+{
+	const auto channel_it = this->_channels.find(name.ascii().ptr());
+	if(channel_it == this->_channels.end())
+		return godot::Dictionary();
+
+	return to_dictionary(channel_it->first, channel_it->second);
+}
+
+bool TsvChannelRegistry::has_channel(const godot::String &name) const
+{
+	return this->_channels.find(name.ascii().ptr()) != this->_channels.end();
+}
+
+void TsvChannelRegistry::watch_channel(const godot::String &name)
+{
+	const std::string channel_name = name.ascii().ptr();
+	if(this->_watched[channel_name]++ == 0)
+		this->_refresh_channel(channel_name);
+
+	this->_update_frame_pre_draw_connection();
+}
+
+void TsvChannelRegistry::unwatch_channel(const godot::String &name)
+{
+	const auto watched_it = this->_watched.find(name.ascii().ptr());
+	if(watched_it == this->_watched.end())
+		return;
+
+	if(--watched_it->second == 0)
+	{
+		// Channels of other processes are no longer refreshed, drop them instead of keeping stale data
+		const std::string channel_name = watched_it->first;
+		this->_watched.erase(watched_it);
+
+		const auto channel_it = this->_channels.find(channel_name);
+		if(channel_it != this->_channels.end() && !channel_it->second.local)
+			this->_remove_channel(channel_name);
+	}
+
+	this->_update_frame_pre_draw_connection();
+}
+
+void TsvChannelRegistry::refresh()
+{
+	// Signal handlers may (un)watch channels, iterate over a copy
+	const auto watched = this->_watched;
+	for(const auto &[name, count] : watched)
+		this->_refresh_channel(name);
+}
+
+void TsvChannelRegistry::publish_local(const std::string &name, uint32_t width, uint32_t height,
+                                       godot::Image::Format format, const godot::String &producer)
+{
+	ChannelInfo info;
+	info.width       = width;
+	info.height      = height;
+	info.format      = format;
+	info.producer    = producer;
+	info.last_update = godot::Time::get_singleton()->get_ticks_msec();
+	info.local       = true;
+
+	this->_set_channel(name, info);
+}
+
+void TsvChannelRegistry::touch_local(const std::string &name)
+{
+	auto channel_it = this->_channels.find(name);
+	if(channel_it != this->_channels.end())
+		channel_it->second.last_update = godot::Time::get_singleton()->get_ticks_msec();
+}
+
+void TsvChannelRegistry::unpublish_local(const std::string &name)
+{
+	const auto channel_it = this->_channels.find(name);
+	if(channel_it != this->_channels.end() && channel_it->second.local)
+		this->_remove_channel(name);
+}
+
+void TsvChannelRegistry::_bind_methods()
+{
+	using godot::ClassDB;
+	using godot::D_METHOD;
+	using godot::MethodInfo;
+	using godot::PropertyInfo;
+
+	ClassDB::bind_method(D_METHOD("get_channels"), &TsvChannelRegistry::get_channels);
+	ClassDB::bind_method(D_METHOD("get_channel", "name"), &TsvChannelRegistry::get_channel);
+	ClassDB::bind_method(D_METHOD("has_channel", "name"), &TsvChannelRegistry::has_channel);
+
+	ClassDB::bind_method(D_METHOD("watch_channel", "name"), &TsvChannelRegistry::watch_channel);
+	ClassDB::bind_method(D_METHOD("unwatch_channel", "name"), &TsvChannelRegistry::unwatch_channel);
+	ClassDB::bind_method(D_METHOD("refresh"), &TsvChannelRegistry::refresh);
+
+	ADD_SIGNAL(MethodInfo("channel_added", PropertyInfo(godot::Variant::STRING, "name")));
+	ADD_SIGNAL(MethodInfo("channel_changed", PropertyInfo(godot::Variant::STRING, "name")));
+	ADD_SIGNAL(MethodInfo("channel_removed", PropertyInfo(godot::Variant::STRING, "name")));
+
+	// Connect this to "frame_pre_draw"
+	ClassDB::bind_method(D_METHOD("__refresh"), &TsvChannelRegistry::refresh);
+}
+
+bool TsvChannelRegistry::_init_client()
+{
+	if(this->_tsv_client_initialized)
+		return true;
+
+	// The client is only created once a channel is watched, RenderingServer isn't available during module
+	// initialization
+#ifdef USE_OPENGL
+	if(!TextureShareGlClient::initialize_gl_external())
+		ERR_PRINT("Failed to load OpenGL Extensions");
+
+	if(!this->_tsv_client.init_with_server_launch())
+	{
+		ERR_PRINT("Failed to launch/connect to shared texture server");
+		return false;
+	}
+#else
+	using godot::RenderingDevice;
+	using godot::RID;
+
+	godot::RenderingDevice *const prd = godot::RenderingServer::get_singleton()->get_rendering_device();
+	if(!prd)
+	{
+		WARN_PRINT("Unable to load RenderingDevice. Can't use TsvChannelRegistry without Renderer");
+		return false;
+	}
+
+	VkInstance vk_inst =
+		(VkInstance)prd->get_driver_resource(RenderingDevice::DRIVER_RESOURCE_VULKAN_INSTANCE, RID(), 0);
+	VkPhysicalDevice vk_ph_dev =
+		(VkPhysicalDevice)prd->get_driver_resource(RenderingDevice::DRIVER_RESOURCE_VULKAN_PHYSICAL_DEVICE, RID(), 0);
+	VkDevice vk_dev   = (VkDevice)prd->get_driver_resource(RenderingDevice::DRIVER_RESOURCE_VULKAN_DEVICE, RID(), 0);
+	VkQueue  vk_queue = (VkQueue)prd->get_driver_resource(RenderingDevice::DRIVER_RESOURCE_VULKAN_QUEUE, RID(), 0);
+	uint32_t vk_queue_index =
+		(uint32_t)prd->get_driver_resource(RenderingDevice::DRIVER_RESOURCE_VULKAN_QUEUE_FAMILY_INDEX, RID(), 0);
+
+	TextureShareVkSetup vk_setup;
+	vk_setup.import_vulkan(vk_inst, vk_dev, vk_ph_dev, vk_queue, vk_queue_index, true);
+	if(!this->_tsv_client.init_with_server_launch(vk_setup.release()))
+	{
+		ERR_PRINT("Failed to launch/connect to VkServer");
+		return false;
+	}
+#endif
+
+	this->_tsv_client_initialized = true;
+	return true;
+}
+
+void TsvChannelRegistry::_update_frame_pre_draw_connection()
+{
+	godot::RenderingServer *const prs = godot::RenderingServer::get_singleton();
+	const godot::Callable         refresh_callable(this, "__refresh");
+
+	const bool is_connected = prs->is_connected("frame_pre_draw", refresh_callable);
+	if(!this->_watched.empty() && !is_connected)
+		prs->connect("frame_pre_draw", refresh_callable);
+	else if(this->_watched.empty() && is_connected)
+		prs->disconnect("frame_pre_draw", refresh_callable);
+}
+
+void TsvChannelRegistry::_refresh_channel(const std::string &name)
+{
+	// Local channels are updated by their senders
+	const auto channel_it = this->_channels.find(name);
+	if(channel_it != this->_channels.end() && channel_it->second.local)
+		return;
+
+	if(!this->_init_client())
+		return;
+
+	ImageLookupResult res = this->_tsv_client.find_image(name.c_str(), false);
+	if(res == ImageLookupResult::Error)
+	{
+		// Keep the last known info, the lookup is retried on the next refresh
+		ERR_PRINT_ONCE(godot::String("TsvChannelRegistry: Failed to look up shared texture ") + name.c_str());
+		return;
+	}
+	else if(res == ImageLookupResult::NotFound)
+	{
+		if(channel_it != this->_channels.end())
+			this->_remove_channel(name);
+
+		return;
+	}
+	else if(res == ImageLookupResult::Found && channel_it != this->_channels.end())
+		return; // Unchanged
+
+	if(res == ImageLookupResult::RequiresUpdate)
+	{
+		res = this->_tsv_client.find_image(name.c_str(), true);
+		if(res != ImageLookupResult::Found)
+			return;
+	}
+
+	const auto  data_lock = this->_tsv_client.find_image_data(name.c_str(), false);
+	const auto *data      = data_lock.read();
+	if(data == nullptr)
+		return;
+
+	ChannelInfo info;
+	info.width       = data->width;
+	info.height      = data->height;
+	info.format      = convert_rendering_device_to_godot_format(data->format);
+	info.last_update = godot::Time::get_singleton()->get_ticks_msec();
+
+	this->_set_channel(name, info);
+}
+
+void TsvChannelRegistry::_set_channel(const std::string &name, const ChannelInfo &info)
+{
+	auto channel_it = this->_channels.find(name);
+	if(channel_it == this->_channels.end())
+	{
+		this->_channels.emplace(name, info);
+		this->emit_signal("channel_added", godot::String(name.c_str()));
+	}
+	else
+	{
+		channel_it->second = info;
+		this->emit_signal("channel_changed", godot::String(name.c_str()));
+	}
+}
+
+void TsvChannelRegistry::_remove_channel(const std::string &name)
+{
+	this->_channels.erase(name);
+	this->emit_signal("channel_removed", godot::String(name.c_str()));
+}
+
+godot::Dictionary TsvChannelRegistry::to_dictionary(const std::string &name, const ChannelInfo &info)
+{
+	godot::Dictionary dict;
+	dict["name"]        = godot::String(name.c_str());
+	dict["width"]       = info.width;
+	dict["height"]      = info.height;
+	dict["format"]      = info.format;
+	dict["producer"]    = info.producer;
+	dict["last_update"] = info.last_update;
+
+	return dict;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <gdextension_interface.h>
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+
+#include <map>
+#include <string>
+
+#include "rendering_backend.hpp"
+
+/*! \brief Process-wide list of shared texture channels. Available to GDScript as the `TsvChannelRegistry` singleton
+ *
+ * Channels published by TsvSenders of this process are registered directly. Channels of other processes are looked
+ * up once per frame for all watched names, instead of every TsvReceiveTexture polling the server on its own.
+ *
+ * The TextureShareVk server can't list its images, so channels of other processes are only known while their name is
+ * watched. TsvReceiveTexture only watches a channel until it has been published, after which the channel is removed
+ * from the registry again (emitting channel_removed) and the receiver polls it directly.
+ */
+class TsvChannelRegistry : public godot::Object
+{
+	GDCLASS(TsvChannelRegistry, godot::Object);
+
+	public:
+	struct ChannelInfo
+	{
+		uint32_t             width       = 0;
+		uint32_t             height      = 0;
+		godot::Image::Format format      = godot::Image::FORMAT_MAX;
+		godot::String        producer    = godot::String();
+		uint64_t             last_update = 0;
+		bool                 local       = false;
+	};
+
+	TsvChannelRegistry();
+	~TsvChannelRegistry() override;
+
+	static TsvChannelRegistry *get_singleton();
+
+	/*! \brief Get all known channels as an array of dictionaries with keys name, width, height, format, producer and
+	 * last_update (in msec)
+	 */
+	godot::Array get_channels() const;
+
+	/*! \brief Get a single channel's info. Returns an empty dictionary if the channel is unknown
+	 */
+	godot::Dictionary get_channel(const godot::String &name) const;
+
+	/*! \brief Check if a channel is currently published
+	 */
+	bool has_channel(const godot::String &name) const;
+
+	/*! \brief Look for a channel published by another process. Emits channel_added once it becomes available
+	 */
+	void watch_channel(const godot::String &name);
+
+	/*! \brief Stop looking for a channel. Once no longer watched, a channel of another process is dropped from the
+	 * registry and channel_removed is emitted
+	 */
+	void unwatch_channel(const godot::String &name);
+
+	/*! \brief Look up all watched channels. Called automatically before every frame while channels are watched
+	 */
+	void refresh();
+
+	/*! \brief Register a channel published by this process
+	 */
+	void publish_local(const std::string &name, uint32_t width, uint32_t height, godot::Image::Format format,
+	                   const godot::String &producer);
+
+	/*! \brief Mark a locally published channel as updated
+	 */
+	void touch_local(const std::string &name);
+
+	/*! \brief Remove a channel published by this process
+	 */
+	void unpublish_local(const std::string &name);
+
+	protected:
+	static void _bind_methods();
+
+	private:
+	static TsvChannelRegistry *_singleton;
+
+	std::map<std::string, ChannelInfo> _channels;
+	std::map<std::string, uint32_t>    _watched;
+
+	texture_share_client_t _tsv_client;
+	bool                   _tsv_client_initialized = false;
+
+	bool _init_client();
+	void _update_frame_pre_draw_connection();
+	void _refresh_channel(const std::string &name);
+	void _set_channel(const std::string &name, const ChannelInfo &info);
+	void _remove_channel(const std::string &name);
+
+	static godot::Dictionary to_dictionary(const std::string &name, const ChannelInfo &info);
+};
@@ -1,6 +1,9 @@
 #include "tsv_receive_texture.hpp"
 
+#include "copy_region.hpp"
 #include "format_conversion.hpp"
+#include "tsv_channel_registry.hpp"
+#include "tsv_transfer_scheduler.hpp"
 
 #include <assert.h>
 
@@ -10,6 +13,10 @@
 
 TsvReceiveTexture::TsvReceiveTexture()
 {
+	TsvTransferScheduler *const scheduler = TsvTransferScheduler::get_singleton();
+	if(scheduler)
+		this->_transfer_channel = scheduler->add_channel(this->_transfer_priority, this->_transfer_max_deferred_frames);
+
 #ifdef USE_OPENGL
 	if(!TextureShareGlClient::initialize_gl_external())
 		ERR_PRINT("Failed to load OpenGL Extensions");
@@ -53,6 +60,12 @@ TsvReceiveTexture::TsvReceiveTexture()
 
 TsvReceiveTexture::~TsvReceiveTexture()
 {
+	this->_unwatch_shared_texture();
+
+	TsvTransferScheduler *const scheduler = TsvTransferScheduler::get_singleton();
+	if(scheduler)
+		scheduler->remove_channel(this->_transfer_channel);
+
 	godot::RenderingServer *const prs = godot::RenderingServer::get_singleton();
 
 	if(this->_texture.is_valid())
@@ -125,13 +138,62 @@ void TsvReceiveTexture::set_shared_texture_name(const godot::String &shared_name
 	if(godot::String(this->_shared_texture_name.c_str()) == shared_name)
 		return;
 
-	if(!this->is_connected_to_frame_pre_draw())
-		this->connect_to_frame_pre_draw();
+	this->_unwatch_shared_texture();
 
 	this->_shared_texture_name =
 		std::string((const char *)shared_name.to_ascii_buffer().ptr(), shared_name.to_ascii_buffer().size());
+	// If the channel isn't available yet, receive_texture_internal starts watching it on the next frame
 	this->_shared_texture_initialized = false;
-	this->_check_and_update_shared_texture();
+	if(!this->_check_and_update_shared_texture() && !this->is_connected_to_frame_pre_draw())
+		this->connect_to_frame_pre_draw();
+}
+
+bool TsvReceiveTexture::get_flip_h() const
+{
+	return this->_flip_h;
+}
+
+void TsvReceiveTexture::set_flip_h(bool flip_h)
+{
+	this->_flip_h = flip_h;
+}
+
+bool TsvReceiveTexture::get_flip_v() const
+{
+	return this->_flip_v;
+}
+
+void TsvReceiveTexture::set_flip_v(bool flip_v)
+{
+	this->_flip_v = flip_v;
+}
+
+int32_t TsvReceiveTexture::get_transfer_priority() const
+{
+	return this->_transfer_priority;
+}
+
+void TsvReceiveTexture::set_transfer_priority(int32_t priority)
+{
+	this->_transfer_priority = priority;
+
+	TsvTransferScheduler *const scheduler = TsvTransferScheduler::get_singleton();
+	if(scheduler)
+		scheduler->set_channel_priority(this->_transfer_channel, priority);
+}
+
+int32_t TsvReceiveTexture::get_transfer_max_deferred_frames() const
+{
+	return this->_transfer_max_deferred_frames;
+}
+
+void TsvReceiveTexture::set_transfer_max_deferred_frames(int32_t max_deferred_frames)
+{
+	this->_transfer_max_deferred_frames = std::max(max_deferred_frames, 0);
+
+	TsvTransferScheduler *const scheduler = TsvTransferScheduler::get_singleton();
+	if(scheduler)
+		scheduler->set_channel_max_deferred_frames(this->_transfer_channel, this->_transfer_max_deferred_frames);
 }
 
 void TsvReceiveTexture::_receive_texture()
@@ -171,6 +233,28 @@ void TsvReceiveTexture::_bind_methods()
 	ClassDB::add_property("TsvReceiveTexture", PropertyInfo(godot::Variant::STRING, "shared_texture_name"),
 	                      "set_shared_texture_name", "get_shared_texture_name");
 
+	ClassDB::bind_method(D_METHOD("get_flip_h"), &TsvReceiveTexture::get_flip_h);
+	ClassDB::bind_method(D_METHOD("set_flip_h", "flip_h"), &TsvReceiveTexture::set_flip_h);
+	ClassDB::add_property("TsvReceiveTexture", PropertyInfo(godot::Variant::BOOL, "flip_h"), "set_flip_h",
+	                      "get_flip_h");
+
+	ClassDB::bind_method(D_METHOD("get_flip_v"), &TsvReceiveTexture::get_flip_v);
+	ClassDB::bind_method(D_METHOD("set_flip_v", "flip_v"), &TsvReceiveTexture::set_flip_v);
+	ClassDB::add_property("TsvReceiveTexture", PropertyInfo(godot::Variant::BOOL, "flip_v"), "set_flip_v",
+	                      "get_flip_v");
+
+	ClassDB::bind_method(D_METHOD("get_transfer_priority"), &TsvReceiveTexture::get_transfer_priority);
+	ClassDB::bind_method(D_METHOD("set_transfer_priority", "priority"), &TsvReceiveTexture::set_transfer_priority);
+	ClassDB::add_property("TsvReceiveTexture", PropertyInfo(godot::Variant::INT, "transfer_priority"),
+	                      "set_transfer_priority", "get_transfer_priority");
+
+	ClassDB::bind_method(D_METHOD("get_transfer_max_deferred_frames"),
+	                     &TsvReceiveTexture::get_transfer_max_deferred_frames);
+	ClassDB::bind_method(D_METHOD("set_transfer_max_deferred_frames", "max_deferred_frames"),
+	                     &TsvReceiveTexture::set_transfer_max_deferred_frames);
+	ClassDB::add_property("TsvReceiveTexture", PropertyInfo(godot::Variant::INT, "transfer_max_deferred_frames"),
+	                      "set_transfer_max_deferred_frames", "get_transfer_max_deferred_frames");
+
 	ClassDB::bind_method(D_METHOD("connect_to_frame_pre_draw"), &TsvReceiveTexture::connect_to_frame_pre_draw);
 	ClassDB::bind_method(D_METHOD("is_connected_to_frame_pre_draw"),
 	                     &TsvReceiveTexture::is_connected_to_frame_pre_draw);
@@ -178,6 +262,9 @@ void TsvReceiveTexture::_bind_methods()
 
 	ClassDB::bind_method(D_METHOD("_receive_texture"), &TsvReceiveTexture::_receive_texture);
 	ClassDB::bind_method(D_METHOD("__receive_texture"), &TsvReceiveTexture::receive_texture_internal);
+
+	// Connect this to TsvChannelRegistry's "channel_added"
+	ClassDB::bind_method(D_METHOD("__on_channel_added", "name"), &TsvReceiveTexture::_on_channel_added);
 }
 
 // bool SharedTexture::_create_receiver(const std::string &name)
@@ -237,10 +324,73 @@ bool TsvReceiveTexture::_check_and_update_shared_texture()
 	return true;
 }
 
+void TsvReceiveTexture::_watch_shared_texture()
+{
+	TsvChannelRegistry *const registry = TsvChannelRegistry::get_singleton();
+	const godot::String       name(this->_shared_texture_name.c_str());
+
+	// Already waiting for this channel (e.g. _receive_texture was called manually)
+	if(!this->_watched_texture_name.is_empty() && this->_watched_texture_name == name)
+	{
+		if(this->is_connected_to_frame_pre_draw())
+			this->disconnect_to_frame_pre_draw();
+
+		return;
+	}
+
+	this->_unwatch_shared_texture();
+
+	if(!registry || name.is_empty() || registry->has_channel(name))
+	{
+		// Channel exists but couldn't be received, keep checking every frame
+		if(!name.is_empty() && !this->is_connected_to_frame_pre_draw())
+			this->connect_to_frame_pre_draw();
+
+		return;
+	}
+
+	if(this->is_connected_to_frame_pre_draw())
+		this->disconnect_to_frame_pre_draw();
+
+	this->_watched_texture_name = name;
+	registry->connect("channel_added", godot::Callable(this, "__on_channel_added"));
+	registry->watch_channel(name);
+}
+
+void TsvReceiveTexture::_unwatch_shared_texture()
+{
+	if(this->_watched_texture_name.is_empty())
+		return;
+
+	TsvChannelRegistry *const registry = TsvChannelRegistry::get_singleton();
+	if(registry)
+	{
+		registry->disconnect("channel_added", godot::Callable(this, "__on_channel_added"));
+		registry->unwatch_channel(this->_watched_texture_name);
+	}
+
+	this->_watched_texture_name = godot::String();
+}
+
+void TsvReceiveTexture::_on_channel_added(const godot::String &name)
+{
+	if(name != this->_watched_texture_name)
+		return;
+
+	this->_unwatch_shared_texture();
+
+	// If the channel still can't be received, fall back to checking every frame. Watching again here would recurse,
+	// as the registry already knows the channel
+	this->_shared_texture_initialized = false;
+	if(!this->_check_and_update_shared_texture() && !this->is_connected_to_frame_pre_draw())
+		this->connect_to_frame_pre_draw();
+}
+
 void TsvReceiveTexture::_update_texture(const uint64_t width, const uint64_t height, const godot::Image::Format format)
 {
 	this->_width  = width;
 	this->_height = height;
+	this->_format = format;
 
 	// Create new texture with correct width, height, and format
 	godot::Ref<godot::Image> img = godot::Image::create(width, height, false, format);
@@ -262,6 +412,7 @@ void TsvReceiveTexture::_create_initial_texture(const uint64_t width, const uint
 {
 	this->_width  = width;
 	this->_height = height;
+	this->_format = format;
 
 	// Create simple texture
 	godot::Ref<godot::Image> img = godot::Image::create(width, height, false, format);
@@ -278,13 +429,29 @@ void TsvReceiveTexture::_create_initial_texture(const uint64_t width, const uint
 void TsvReceiveTexture::receive_texture_internal()
 {
 	if(!this->_check_and_update_shared_texture())
+	{
+		// Stop polling, the registry notifies us once the channel is published again
+		this->_watch_shared_texture();
 		return;
+	}
+
+	// Defer to a later frame if the transfer budget is used up. The texture keeps showing the last received image
+	TsvTransferScheduler *const scheduler = TsvTransferScheduler::get_singleton();
+	const uint64_t              bytes =
+		(uint64_t)this->_width * this->_height * get_godot_format_pixel_size(this->_format);
+	if(scheduler && !scheduler->request_transfer(this->_transfer_channel, bytes))
+		return;
+
+	// Receive texture. Flip is applied by the copy blit. The extents describe the region of the local texture, so
+	// cropping is only supported by TsvSender
+	const godot::Rect2i region(0, 0, this->_width, this->_height);
+	int32_t             corners[4];
+	get_copy_corners(region, this->_flip_h, this->_flip_v, corners);
 
-		// Receive texture
 #ifdef USE_OPENGL
 	const ImageExtent dim{
-		{0,					 0					 },
-		{(GLsizei)this->_width, (GLsizei)this->_height},
+		{(GLsizei)corners[0], (GLsizei)corners[1]},
+		{(GLsizei)corners[2], (GLsizei)corners[3]},
 	};
 
 	GLint drawFboId = 0;
@@ -292,8 +459,13 @@ void TsvReceiveTexture::receive_texture_internal()
 	this->_tsv_client.recv_image(this->_shared_texture_name.c_str(), this->_texture_id, GL_TEXTURE_2D, false, drawFboId,
 	                             &dim);
 #else
-	// Use VK_IMAGE_LAYOUT_UNDEFINED to discard old data
+	// Use VK_IMAGE_LAYOUT_UNDEFINED to discard old data. The client waits on _fence before returning, a GPU-only
+	// handoff would require semaphore support in both TextureShareVk and Godot (see README)
+	VkOffset3D extents[2]{
+		{corners[0], corners[1], 0},
+		{corners[2], corners[3], 1},
+	};
 	this->_tsv_client.recv_image(this->_shared_texture_name.c_str(), this->_texture_id, VK_IMAGE_LAYOUT_UNDEFINED,
-	                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, this->_fence, nullptr);
+	                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, this->_fence, extents);
 #endif
 }
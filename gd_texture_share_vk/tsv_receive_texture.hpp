@@ -44,6 +44,41 @@ class TsvReceiveTexture : public godot::Texture2D
 	 */
 	void set_shared_texture_name(const godot::String &shared_name);
 
+	/*! \brief Check if the received image is flipped horizontally
+	 */
+	bool get_flip_h() const;
+
+	/*! \brief Flip the received image horizontally. Done during the copy, no additional render pass is required
+	 */
+	void set_flip_h(bool flip_h);
+
+	/*! \brief Check if the received image is flipped vertically
+	 */
+	bool get_flip_v() const;
+
+	/*! \brief Flip the received image vertically (e.g. for images with OpenGL's bottom-up origin). Done during the
+	 * copy, no additional render pass is required
+	 */
+	void set_flip_v(bool flip_v);
+
+	/*! \brief Get the channel's priority in TsvTransferScheduler
+	 */
+	int32_t get_transfer_priority() const;
+
+	/*! \brief Set the channel's priority in TsvTransferScheduler. Higher priority channels are received first when the
+	 * frame's transfer budget is exceeded
+	 */
+	void set_transfer_priority(int32_t priority);
+
+	/*! \brief Get the maximum number of consecutive frames TsvTransferScheduler may defer this channel
+	 */
+	int32_t get_transfer_max_deferred_frames() const;
+
+	/*! \brief Set the maximum number of consecutive frames TsvTransferScheduler may defer this channel. 0 means no
+	 * limit
+	 */
+	void set_transfer_max_deferred_frames(int32_t max_deferred_frames);
+
 	/*! \brief Manually receive texture. SHOULD be called after frame has been prepared (e.g. after `await
 	 * get_tree().process_frame`). It's easier to just connect this SharedTexture to the RenderingDevice's
 	 * frame_pre_draw with `connect_to_frame_pre_draw`
@@ -71,6 +106,12 @@ class TsvReceiveTexture : public godot::Texture2D
 	// bool _create_receiver(const std::string &name);
 
 	bool _check_and_update_shared_texture();
+
+	/*! \brief Wait for TsvChannelRegistry to report the shared texture instead of looking for it every frame
+	 */
+	void _watch_shared_texture();
+	void _unwatch_shared_texture();
+	void _on_channel_added(const godot::String &name);
 	void _update_texture(const uint64_t width, const uint64_t height, const godot::Image::Format format);
 
 	private:
@@ -78,8 +119,18 @@ class TsvReceiveTexture : public godot::Texture2D
 	godot::RID   _texture    = godot::RID();
 	texture_id_t _texture_id = 0;
 
-	int32_t _width  = 0;
-	int32_t _height = 0;
+	int32_t              _width  = 0;
+	int32_t              _height = 0;
+	godot::Image::Format _format = godot::Image::FORMAT_MAX;
+
+	// Copy flip
+	bool _flip_h = false;
+	bool _flip_v = false;
+
+	// TsvTransferScheduler channel
+	uint64_t _transfer_channel             = 0;
+	int32_t  _transfer_priority            = 0;
+	int32_t  _transfer_max_deferred_frames = 0;
 
 	bool _shared_texture_initialized = false;
 	bool _image_found = false;
@@ -89,6 +140,7 @@ class TsvReceiveTexture : public godot::Texture2D
 	// TextureShareReceiver
 	texture_share_client_t _tsv_client;
 	std::string            _shared_texture_name;
+	godot::String          _watched_texture_name;
 
 #ifndef USE_OPENGL
 	VkFence _fence;
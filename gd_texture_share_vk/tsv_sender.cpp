@@ -1,6 +1,9 @@
 #include "tsv_sender.hpp"
 
+#include "copy_region.hpp"
 #include "format_conversion.hpp"
+#include "tsv_channel_registry.hpp"
+#include "tsv_transfer_scheduler.hpp"
 
 #include <assert.h>
 
@@ -9,6 +12,10 @@
 
 TsvSender::TsvSender()
 {
+	TsvTransferScheduler *const scheduler = TsvTransferScheduler::get_singleton();
+	if(scheduler)
+		this->_transfer_channel = scheduler->add_channel(this->_transfer_priority, this->_transfer_max_deferred_frames);
+
 	// Load Extensions
 #ifdef USE_OPENGL
 	if(!TextureShareGlClient::initialize_gl_external())
@@ -55,6 +62,14 @@ TsvSender::TsvSender()
 
 TsvSender::~TsvSender()
 {
+	TsvTransferScheduler *const scheduler = TsvTransferScheduler::get_singleton();
+	if(scheduler)
+		scheduler->remove_channel(this->_transfer_channel);
+
+	TsvChannelRegistry *const registry = TsvChannelRegistry::get_singleton();
+	if(registry && !this->_shared_texture_name.empty())
+		registry->unpublish_local(this->_shared_texture_name);
+
 #ifndef USE_OPENGL
 	godot::RenderingDevice *const prd = godot::RenderingServer::get_singleton()->get_rendering_device();
 	if(!prd)
@@ -76,7 +91,16 @@ TsvSender::~TsvSender()
 
 void TsvSender::set_texture(const godot::Ref<godot::Texture2D> &texture, godot::Image::Format texture_format)
 {
+	const godot::Callable changed_callable(this, "__on_texture_changed");
+	if(this->_texture.is_valid() && this->_texture->is_connected("changed", changed_callable))
+		this->_texture->disconnect("changed", changed_callable);
+
 	this->_texture = texture;
+	this->_on_texture_changed();
+
+	if(this->_texture.is_valid())
+		this->_texture->connect("changed", changed_callable);
+
 	if(!this->_shared_texture_name.empty())
 		this->check_and_update_shared_texture(texture_format);
 }
@@ -91,10 +115,16 @@ void TsvSender::set_shared_texture_name(const godot::String &shared_texture_name
 	const std::string new_name = shared_texture_name.ascii().ptr();
 	if(new_name != this->_shared_texture_name)
 	{
+		TsvChannelRegistry *const registry = TsvChannelRegistry::get_singleton();
+		if(registry && !this->_shared_texture_name.empty())
+			registry->unpublish_local(this->_shared_texture_name);
+
 		this->_shared_texture_name = new_name;
 
-		if(this->_texture.is_valid())
-			this->update_shared_texture(this->_width, this->_height, this->_format);
+		// Force creating and publishing the image under the new name, update_shared_texture skips unchanged parameters
+		this->_width  = 0;
+		this->_height = 0;
+		this->check_and_update_shared_texture(this->_format);
 	}
 }
 
@@ -103,6 +133,101 @@ godot::String TsvSender::get_shared_texture_name()
 	return godot::String(this->_shared_texture_name.c_str());
 }
 
+godot::Rect2i TsvSender::get_source_rect() const
+{
+	return this->_source_rect;
+}
+
+void TsvSender::set_source_rect(const godot::Rect2i &source_rect)
+{
+	// Shared image is resized on next send
+	this->_source_rect = source_rect;
+	this->mark_texture_changed();
+}
+
+bool TsvSender::get_flip_h() const
+{
+	return this->_flip_h;
+}
+
+void TsvSender::set_flip_h(bool flip_h)
+{
+	this->_flip_h = flip_h;
+	this->mark_texture_changed();
+}
+
+bool TsvSender::get_flip_v() const
+{
+	return this->_flip_v;
+}
+
+void TsvSender::set_flip_v(bool flip_v)
+{
+	this->_flip_v = flip_v;
+	this->mark_texture_changed();
+}
+
+bool TsvSender::get_send_only_on_change() const
+{
+	return this->_send_only_on_change;
+}
+
+void TsvSender::set_send_only_on_change(bool send_only_on_change)
+{
+	this->_send_only_on_change = send_only_on_change;
+}
+
+void TsvSender::mark_texture_changed()
+{
+	++this->_texture_generation;
+}
+
+int32_t TsvSender::get_transfer_priority() const
+{
+	return this->_transfer_priority;
+}
+
+void TsvSender::set_transfer_priority(int32_t priority)
+{
+	this->_transfer_priority = priority;
+
+	TsvTransferScheduler *const scheduler = TsvTransferScheduler::get_singleton();
+	if(scheduler)
+		scheduler->set_channel_priority(this->_transfer_channel, priority);
+}
+
+int32_t TsvSender::get_transfer_max_deferred_frames() const
+{
+	return this->_transfer_max_deferred_frames;
+}
+
+void TsvSender::set_transfer_max_deferred_frames(int32_t max_deferred_frames)
+{
+	this->_transfer_max_deferred_frames = std::max(max_deferred_frames, 0);
+
+	TsvTransferScheduler *const scheduler = TsvTransferScheduler::get_singleton();
+	if(scheduler)
+		scheduler->set_channel_max_deferred_frames(this->_transfer_channel, this->_transfer_max_deferred_frames);
+}
+
+void TsvSender::set_cache_native_handle(bool cache_native_handle)
+{
+	this->_cache_texture_id = cache_native_handle;
+	this->_texture_id_valid = false;
+}
+
+void TsvSender::invalidate_native_handle()
+{
+	this->_texture_id_valid = false;
+}
+
+void TsvSender::_on_texture_changed()
+{
+	// Content was replaced, e.g. by ImageTexture::set_image, which creates a new native texture
+	this->_texture_id_valid = false;
+	this->mark_texture_changed();
+}
+
 bool TsvSender::send_texture()
 {
 	return this->send_texture_internal();
@@ -142,6 +267,37 @@ void TsvSender::_bind_methods()
 	ClassDB::add_property("TsvSender", PropertyInfo(godot::Variant::STRING, "shared_texture_name"),
 	                      "set_shared_texture_name", "get_shared_texture_name");
 
+	ClassDB::bind_method(D_METHOD("get_source_rect"), &TsvSender::get_source_rect);
+	ClassDB::bind_method(D_METHOD("set_source_rect", "source_rect"), &TsvSender::set_source_rect);
+	ClassDB::add_property("TsvSender", PropertyInfo(godot::Variant::RECT2I, "source_rect"), "set_source_rect",
+	                      "get_source_rect");
+
+	ClassDB::bind_method(D_METHOD("get_flip_h"), &TsvSender::get_flip_h);
+	ClassDB::bind_method(D_METHOD("set_flip_h", "flip_h"), &TsvSender::set_flip_h);
+	ClassDB::add_property("TsvSender", PropertyInfo(godot::Variant::BOOL, "flip_h"), "set_flip_h", "get_flip_h");
+
+	ClassDB::bind_method(D_METHOD("get_flip_v"), &TsvSender::get_flip_v);
+	ClassDB::bind_method(D_METHOD("set_flip_v", "flip_v"), &TsvSender::set_flip_v);
+	ClassDB::add_property("TsvSender", PropertyInfo(godot::Variant::BOOL, "flip_v"), "set_flip_v", "get_flip_v");
+
+	ClassDB::bind_method(D_METHOD("get_send_only_on_change"), &TsvSender::get_send_only_on_change);
+	ClassDB::bind_method(D_METHOD("set_send_only_on_change", "send_only_on_change"),
+	                     &TsvSender::set_send_only_on_change);
+	ClassDB::add_property("TsvSender", PropertyInfo(godot::Variant::BOOL, "send_only_on_change"),
+	                      "set_send_only_on_change", "get_send_only_on_change");
+	ClassDB::bind_method(D_METHOD("mark_texture_changed"), &TsvSender::mark_texture_changed);
+
+	ClassDB::bind_method(D_METHOD("get_transfer_priority"), &TsvSender::get_transfer_priority);
+	ClassDB::bind_method(D_METHOD("set_transfer_priority", "priority"), &TsvSender::set_transfer_priority);
+	ClassDB::add_property("TsvSender", PropertyInfo(godot::Variant::INT, "transfer_priority"), "set_transfer_priority",
+	                      "get_transfer_priority");
+
+	ClassDB::bind_method(D_METHOD("get_transfer_max_deferred_frames"), &TsvSender::get_transfer_max_deferred_frames);
+	ClassDB::bind_method(D_METHOD("set_transfer_max_deferred_frames", "max_deferred_frames"),
+	                     &TsvSender::set_transfer_max_deferred_frames);
+	ClassDB::add_property("TsvSender", PropertyInfo(godot::Variant::INT, "transfer_max_deferred_frames"),
+	                      "set_transfer_max_deferred_frames", "get_transfer_max_deferred_frames");
+
 	ClassDB::bind_method(D_METHOD("connect_to_frame_post_draw"), &TsvSender::connect_to_frame_post_draw);
 	ClassDB::bind_method(D_METHOD("is_connected_to_frame_post_draw"), &TsvSender::is_connected_to_frame_post_draw);
 	ClassDB::bind_method(D_METHOD("disconnect_to_frame_post_draw"), &TsvSender::disconnect_to_frame_post_draw);
@@ -150,6 +306,9 @@ void TsvSender::_bind_methods()
 
 	// Connect this to "frame_post_draw"
 	ClassDB::bind_method(D_METHOD("__send_texture"), &TsvSender::send_texture_internal);
+
+	// Connect this to the texture's "changed"
+	ClassDB::bind_method(D_METHOD("__on_texture_changed"), &TsvSender::_on_texture_changed);
 }
 
 bool TsvSender::update_shared_texture(uint32_t width, uint32_t height, godot::Image::Format format)
@@ -168,6 +327,14 @@ bool TsvSender::update_shared_texture(uint32_t width, uint32_t height, godot::Im
 
 	this->_tsv_client.init_image(this->_shared_texture_name.c_str(), width, height, tsv_format, true);
 
+	// New shared image has no content yet
+	this->mark_texture_changed();
+
+	TsvChannelRegistry *const registry = TsvChannelRegistry::get_singleton();
+	if(registry)
+		registry->publish_local(this->_shared_texture_name, width, height, format,
+		                        this->get_class() + ":" + godot::String::num_uint64(this->get_instance_id()));
+
 	return true;
 }
 
@@ -175,9 +342,19 @@ bool TsvSender::check_and_update_shared_texture(godot::Image::Format format)
 {
 	if(this->_texture.is_valid() && !this->_shared_texture_name.empty())
 	{
-		const uint32_t new_width  = this->_texture->get_width();
-		const uint32_t new_height = this->_texture->get_height();
-		return this->update_shared_texture(new_width, new_height, format);
+		// Resizing recreates the texture
+		const int32_t texture_width  = this->_texture->get_width();
+		const int32_t texture_height = this->_texture->get_height();
+		if(texture_width != this->_texture_width || texture_height != this->_texture_height)
+		{
+			this->_texture_width    = texture_width;
+			this->_texture_height   = texture_height;
+			this->_texture_id_valid = false;
+		}
+
+		// Shared image only holds the cropped region
+		const godot::Rect2i region = clamp_copy_region(this->_source_rect, texture_width, texture_height);
+		return this->update_shared_texture(region.size.x, region.size.y, format);
 	}
 
 	return false;
@@ -188,24 +365,61 @@ bool TsvSender::send_texture_internal()
 	if(!this->check_and_update_shared_texture(this->_format))
 		return false;
 
-	// Send texture
-	const texture_id_t texture_id =
-		(texture_id_t)godot::RenderingServer::get_singleton()->texture_get_native_handle(this->_texture->get_rid());
+	// Receivers keep the last frame
+	if(this->_send_only_on_change && this->_sent_generation == this->_texture_generation)
+		return true;
+
+	// Defer to a later frame if the transfer budget is used up. The texture stays marked as changed
+	TsvTransferScheduler *const scheduler = TsvTransferScheduler::get_singleton();
+	const uint64_t              bytes =
+		(uint64_t)this->_width * this->_height * get_godot_format_pixel_size(this->_format);
+	if(scheduler && !scheduler->request_transfer(this->_transfer_channel, bytes))
+		return true;
+
+	// Send texture. Crop and flip are applied by the copy blit. Render targets may be recreated without notice, so the
+	// native handle is only reused if the owner keeps track of that
+	if(!this->_cache_texture_id || !this->_texture_id_valid)
+	{
+		this->_texture_id =
+			(texture_id_t)godot::RenderingServer::get_singleton()->texture_get_native_handle(this->_texture->get_rid());
+		this->_texture_id_valid = true;
+	}
+
+	const texture_id_t  texture_id = this->_texture_id;
+	const godot::Rect2i region     = clamp_copy_region(this->_source_rect, this->_texture_width, this->_texture_height);
+	int32_t             corners[4];
+	get_copy_corners(region, this->_flip_h, this->_flip_v, corners);
 
 #ifdef USE_OPENGL
 	const ImageExtent dim{
-		{0,					 0					 },
-		{(GLsizei)this->_width, (GLsizei)this->_height},
+		{(GLsizei)corners[0], (GLsizei)corners[1]},
+		{(GLsizei)corners[2], (GLsizei)corners[3]},
 	};
 
 	GLint drawFboId = 0;
 	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFboId);
-	this->_tsv_client.send_image(this->_shared_texture_name.c_str(), texture_id, GL_TEXTURE_2D, false, drawFboId, &dim);
+	const ImageLookupResult res = this->_tsv_client.send_image(this->_shared_texture_name.c_str(), texture_id,
+	                                                           GL_TEXTURE_2D, false, drawFboId, &dim);
 #else
-	this->_tsv_client.send_image(this->_shared_texture_name.c_str(), texture_id,
-	                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-	                             this->_fence, nullptr);
+	// The client waits on _fence before returning (see README)
+	VkOffset3D extents[2]{
+		{corners[0], corners[1], 0},
+		{corners[2], corners[3], 1},
+	};
+	const ImageLookupResult res = this->_tsv_client.send_image(
+		this->_shared_texture_name.c_str(), texture_id, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, this->_fence, extents);
 #endif
 
+	// Keep the texture marked as changed, so that it's sent again on the next call
+	if(res != ImageLookupResult::Found)
+		return false;
+
+	this->_sent_generation = this->_texture_generation;
+
+	TsvChannelRegistry *const registry = TsvChannelRegistry::get_singleton();
+	if(registry)
+		registry->touch_local(this->_shared_texture_name);
+
 	return true;
 }
@@ -33,6 +33,62 @@ class TsvSender : public godot::Resource
 	 */
 	godot::String get_shared_texture_name();
 
+	/*! \brief Get the region of the texture that is shared
+	 */
+	godot::Rect2i get_source_rect() const;
+
+	/*! \brief Only share a region of the texture. The shared image is resized to the region. An empty rect, or one
+	 * outside of the texture, shares the entire texture
+	 */
+	void set_source_rect(const godot::Rect2i &source_rect);
+
+	/*! \brief Check if the shared image is flipped horizontally
+	 */
+	bool get_flip_h() const;
+
+	/*! \brief Flip the shared image horizontally. Done during the copy, no additional render pass is required
+	 */
+	void set_flip_h(bool flip_h);
+
+	/*! \brief Check if the shared image is flipped vertically
+	 */
+	bool get_flip_v() const;
+
+	/*! \brief Flip the shared image vertically. Done during the copy, no additional render pass is required
+	 */
+	void set_flip_v(bool flip_v);
+
+	/*! \brief Check if unchanged textures are skipped
+	 */
+	bool get_send_only_on_change() const;
+
+	/*! \brief Only send the texture if it changed since the last send. Changes are detected with the texture's
+	 * changed signal. Textures that don't emit it (e.g. ViewportTexture) must be marked with `mark_texture_changed`
+	 */
+	void set_send_only_on_change(bool send_only_on_change);
+
+	/*! \brief Mark the texture's content as changed, so that it is sent on the next update
+	 */
+	void mark_texture_changed();
+
+	/*! \brief Get the channel's priority in TsvTransferScheduler
+	 */
+	int32_t get_transfer_priority() const;
+
+	/*! \brief Set the channel's priority in TsvTransferScheduler. Higher priority channels are sent first when the
+	 * frame's transfer budget is exceeded
+	 */
+	void set_transfer_priority(int32_t priority);
+
+	/*! \brief Get the maximum number of consecutive frames TsvTransferScheduler may defer this channel
+	 */
+	int32_t get_transfer_max_deferred_frames() const;
+
+	/*! \brief Set the maximum number of consecutive frames TsvTransferScheduler may defer this channel. 0 means no
+	 * limit
+	 */
+	void set_transfer_max_deferred_frames(int32_t max_deferred_frames);
+
 	/*! \brief Explicitly update the shared texture. MUST be called after the frame has been drawn (use after `await
 	 * get_tree().process_frame`). It's easier to just connect this SharedTexture to the RenderingDevice's
 	 * frame_post_draw with `connect_to_frame_post_draw()`
@@ -52,17 +108,49 @@ class TsvSender : public godot::Resource
 	 */
 	void disconnect_to_frame_post_draw();
 
+	/*! \brief Only look up the texture's native handle again when the texture is replaced or resized. Only enable this
+	 * if the owner is notified whenever the texture's native texture is recreated (e.g. TsvViewportSender). Otherwise,
+	 * the handle is looked up on every send
+	 */
+	void set_cache_native_handle(bool cache_native_handle);
+
+	/*! \brief Look up the texture's native handle again on the next send
+	 */
+	void invalidate_native_handle();
+
 	protected:
 	static void _bind_methods();
 
 	private:
 	godot::Ref<godot::Texture2D> _texture;
 
+	// Cached native handle of _texture. Only used if _cache_texture_id is set
+	texture_id_t _texture_id       = 0;
+	bool         _texture_id_valid = false;
+	bool         _cache_texture_id = false;
+	int32_t      _texture_width    = 0;
+	int32_t      _texture_height   = 0;
+
 	std::string          _shared_texture_name;
 	uint32_t             _width  = 0;
 	uint32_t             _height = 0;
 	godot::Image::Format _format = godot::Image::FORMAT_MAX;
 
+	// Copy region
+	godot::Rect2i _source_rect = godot::Rect2i();
+	bool          _flip_h      = false;
+	bool          _flip_v      = false;
+
+	// Change detection
+	bool     _send_only_on_change = false;
+	uint64_t _texture_generation  = 0;
+	uint64_t _sent_generation     = 0;
+
+	// TsvTransferScheduler channel
+	uint64_t _transfer_channel             = 0;
+	int32_t  _transfer_priority            = 0;
+	int32_t  _transfer_max_deferred_frames = 0;
+
 	texture_share_client_t _tsv_client;
 #ifndef USE_OPENGL
 	VkFence _fence;
@@ -72,4 +160,5 @@ class TsvSender : public godot::Resource
 	bool check_and_update_shared_texture(godot::Image::Format format);
 
 	bool send_texture_internal();
+	void _on_texture_changed();
 };
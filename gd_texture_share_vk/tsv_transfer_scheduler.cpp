@@ -0,0 +1,109 @@
+#include "tsv_transfer_scheduler.hpp"
+
+#include <assert.h>
+
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/core/class_db.hpp>
+
+TsvTransferScheduler *TsvTransferScheduler::_singleton = nullptr;
+
+TsvTransferScheduler::TsvTransferScheduler()
+{
+	assert(_singleton == nullptr);
+	_singleton = this;
+}
+
+TsvTransferScheduler::~TsvTransferScheduler()
+{
+	if(_singleton == this)
+		_singleton = nullptr;
+}
+
+TsvTransferScheduler *TsvTransferScheduler::get_singleton()
+{
+	return _singleton;
+}
+
+int64_t TsvTransferScheduler::get_frame_byte_budget() const
+{
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	return (int64_t)this->_scheduler.get_frame_byte_budget();
+}
+
+void TsvTransferScheduler::set_frame_byte_budget(int64_t budget)
+{
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	this->_scheduler.set_frame_byte_budget(budget > 0 ? (uint64_t)budget : 0);
+}
+
+godot::Dictionary TsvTransferScheduler::get_last_frame_stats() const
+{
+	TransferScheduler::FrameStats stats;
+	{
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		stats = this->_scheduler.get_last_frame_stats();
+	}
+
+	godot::Dictionary dict;
+	dict["frame"]          = stats.frame;
+	dict["budget_bytes"]   = stats.budget_bytes;
+	dict["granted_bytes"]  = stats.granted_bytes;
+	dict["granted_count"]  = stats.granted_count;
+	dict["deferred_count"] = stats.deferred_count;
+	dict["forced_count"]   = stats.forced_count;
+
+	return dict;
+}
+
+int64_t TsvTransferScheduler::get_channel_count() const
+{
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	return (int64_t)this->_scheduler.get_channel_count();
+}
+
+TsvTransferScheduler::channel_id_t TsvTransferScheduler::add_channel(int32_t priority, uint32_t max_deferred_frames)
+{
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	return this->_scheduler.add_channel(priority, max_deferred_frames);
+}
+
+void TsvTransferScheduler::remove_channel(channel_id_t id)
+{
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	this->_scheduler.remove_channel(id);
+}
+
+void TsvTransferScheduler::set_channel_priority(channel_id_t id, int32_t priority)
+{
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	this->_scheduler.set_channel_priority(id, priority);
+}
+
+void TsvTransferScheduler::set_channel_max_deferred_frames(channel_id_t id, uint32_t max_deferred_frames)
+{
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	this->_scheduler.set_channel_max_deferred_frames(id, max_deferred_frames);
+}
+
+bool TsvTransferScheduler::request_transfer(channel_id_t id, uint64_t bytes)
+{
+	const uint64_t frame = godot::Engine::get_singleton()->get_frames_drawn();
+
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	return this->_scheduler.request_transfer(id, frame, bytes);
+}
+
+void TsvTransferScheduler::_bind_methods()
+{
+	using godot::ClassDB;
+	using godot::D_METHOD;
+	using godot::PropertyInfo;
+
+	ClassDB::bind_method(D_METHOD("get_frame_byte_budget"), &TsvTransferScheduler::get_frame_byte_budget);
+	ClassDB::bind_method(D_METHOD("set_frame_byte_budget", "budget"), &TsvTransferScheduler::set_frame_byte_budget);
+	ClassDB::add_property("TsvTransferScheduler", PropertyInfo(godot::Variant::INT, "frame_byte_budget"),
+	                      "set_frame_byte_budget", "get_frame_byte_budget");
+
+	ClassDB::bind_method(D_METHOD("get_last_frame_stats"), &TsvTransferScheduler::get_last_frame_stats);
+	ClassDB::bind_method(D_METHOD("get_channel_count"), &TsvTransferScheduler::get_channel_count);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <gdextension_interface.h>
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+
+#include <mutex>
+
+#include "transfer_scheduler.hpp"
+
+/*! \brief Enforces a per-frame transfer budget across all TsvSenders and TsvReceiveTextures. Available to GDScript as
+ * the `TsvTransferScheduler` singleton
+ *
+ * Each sender and receiver registers a channel with a priority and a maximum number of consecutive deferred frames.
+ * Once the frame's byte budget is used up, lower-priority transfers are deferred to later frames. The budget is
+ * disabled by default.
+ *
+ * Thread-safe. Channels are added and removed from resource constructors and destructors, which may run on loader
+ * threads, while transfers are requested from the render thread.
+ */
+class TsvTransferScheduler : public godot::Object
+{
+	GDCLASS(TsvTransferScheduler, godot::Object);
+
+	public:
+	using channel_id_t = TransferScheduler::channel_id_t;
+
+	TsvTransferScheduler();
+	~TsvTransferScheduler() override;
+
+	static TsvTransferScheduler *get_singleton();
+
+	/*! \brief Get the number of bytes that may be transferred per frame
+	 */
+	int64_t get_frame_byte_budget() const;
+
+	/*! \brief Set the number of bytes that may be transferred per frame. 0 disables the budget
+	 */
+	void set_frame_byte_budget(int64_t budget);
+
+	/*! \brief Get statistics of the last frame as a dictionary with keys frame, budget_bytes, granted_bytes,
+	 * granted_count, deferred_count and forced_count
+	 */
+	godot::Dictionary get_last_frame_stats() const;
+
+	/*! \brief Get the number of registered channels
+	 */
+	int64_t get_channel_count() const;
+
+	channel_id_t add_channel(int32_t priority, uint32_t max_deferred_frames);
+	void         remove_channel(channel_id_t id);
+	void         set_channel_priority(channel_id_t id, int32_t priority);
+	void         set_channel_max_deferred_frames(channel_id_t id, uint32_t max_deferred_frames);
+
+	/*! \brief Request a transfer for the current frame
+	 * \return Returns true if the transfer should be done now, false if it should be deferred
+	 */
+	bool request_transfer(channel_id_t id, uint64_t bytes);
+
+	protected:
+	static void _bind_methods();
+
+	private:
+	static TsvTransferScheduler *_singleton;
+
+	mutable std::mutex _mutex;
+	TransferScheduler  _scheduler;
+};
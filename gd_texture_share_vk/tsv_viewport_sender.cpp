@@ -0,0 +1,231 @@
+#include "tsv_viewport_sender.hpp"
+
+#include <godot_cpp/classes/canvas_item.hpp>
+#include <godot_cpp/classes/rendering_server.hpp>
+#include <godot_cpp/classes/sub_viewport_container.hpp>
+#include <godot_cpp/classes/viewport_texture.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/object.hpp>
+
+TsvViewportSender::TsvViewportSender()
+{
+	this->_sender.instantiate();
+
+	// Viewport rendering state decides whether the texture changed
+	this->_sender->set_send_only_on_change(true);
+
+	// Resizing and render target settings are tracked here, so the native handle only needs to be looked up after that
+	this->_sender->set_cache_native_handle(true);
+}
+
+TsvViewportSender::~TsvViewportSender()
+{
+	this->_detach_viewport();
+}
+
+godot::NodePath TsvViewportSender::get_viewport_path() const
+{
+	return this->_viewport_path;
+}
+
+void TsvViewportSender::set_viewport_path(const godot::NodePath &viewport_path)
+{
+	if(this->_viewport_path == viewport_path)
+		return;
+
+	this->_viewport_path = viewport_path;
+	if(this->is_inside_tree())
+	{
+		this->_detach_viewport();
+		this->_attach_viewport();
+	}
+}
+
+godot::String TsvViewportSender::get_shared_texture_name() const
+{
+	return this->_sender->get_shared_texture_name();
+}
+
+void TsvViewportSender::set_shared_texture_name(const godot::String &shared_texture_name)
+{
+	this->_sender->set_shared_texture_name(shared_texture_name);
+	this->_texture_dirty = true;
+}
+
+godot::Ref<TsvSender> TsvViewportSender::get_sender() const
+{
+	return this->_sender;
+}
+
+void TsvViewportSender::refresh()
+{
+	this->_texture_dirty = true;
+}
+
+void TsvViewportSender::_notification(int what)
+{
+	if(what == NOTIFICATION_ENTER_TREE)
+		this->_attach_viewport();
+	else if(what == NOTIFICATION_EXIT_TREE)
+		this->_detach_viewport();
+}
+
+void TsvViewportSender::_bind_methods()
+{
+	using godot::ClassDB;
+	using godot::D_METHOD;
+	using godot::PropertyInfo;
+
+	ClassDB::bind_method(D_METHOD("get_viewport_path"), &TsvViewportSender::get_viewport_path);
+	ClassDB::bind_method(D_METHOD("set_viewport_path", "viewport_path"), &TsvViewportSender::set_viewport_path);
+	ClassDB::add_property("TsvViewportSender", PropertyInfo(godot::Variant::NODE_PATH, "viewport_path"),
+	                      "set_viewport_path", "get_viewport_path");
+
+	ClassDB::bind_method(D_METHOD("get_shared_texture_name"), &TsvViewportSender::get_shared_texture_name);
+	ClassDB::bind_method(D_METHOD("set_shared_texture_name", "shared_texture_name"),
+	                     &TsvViewportSender::set_shared_texture_name);
+	ClassDB::add_property("TsvViewportSender", PropertyInfo(godot::Variant::STRING, "shared_texture_name"),
+	                      "set_shared_texture_name", "get_shared_texture_name");
+
+	ClassDB::bind_method(D_METHOD("get_sender"), &TsvViewportSender::get_sender);
+	ClassDB::bind_method(D_METHOD("refresh"), &TsvViewportSender::refresh);
+
+	// Connect this to the viewport's "size_changed"
+	ClassDB::bind_method(D_METHOD("__on_viewport_size_changed"), &TsvViewportSender::_on_viewport_size_changed);
+
+	// Connect this to "frame_post_draw"
+	ClassDB::bind_method(D_METHOD("__on_frame_post_draw"), &TsvViewportSender::_on_frame_post_draw);
+}
+
+godot::SubViewport *TsvViewportSender::_get_viewport() const
+{
+	if(this->_viewport_id == 0)
+		return nullptr;
+
+	return godot::Object::cast_to<godot::SubViewport>(godot::ObjectDB::get_instance(this->_viewport_id));
+}
+
+void TsvViewportSender::_attach_viewport()
+{
+	godot::Node *const node =
+		this->_viewport_path.is_empty() ? this->get_parent() : this->get_node_or_null(this->_viewport_path);
+	godot::SubViewport *const viewport = godot::Object::cast_to<godot::SubViewport>(node);
+	if(!viewport)
+	{
+		WARN_PRINT("TsvViewportSender requires a SubViewport. Set viewport_path or add it as a child of a SubViewport");
+		return;
+	}
+
+	this->_viewport_id = viewport->get_instance_id();
+	this->_update_mode = viewport->get_update_mode();
+	viewport->connect("size_changed", godot::Callable(this, "__on_viewport_size_changed"));
+	godot::RenderingServer::get_singleton()->connect("frame_post_draw", godot::Callable(this, "__on_frame_post_draw"));
+
+	this->_texture_dirty = true;
+}
+
+void TsvViewportSender::_detach_viewport()
+{
+	godot::RenderingServer *const prs = godot::RenderingServer::get_singleton();
+	const godot::Callable         post_draw_callable(this, "__on_frame_post_draw");
+	if(prs->is_connected("frame_post_draw", post_draw_callable))
+		prs->disconnect("frame_post_draw", post_draw_callable);
+
+	const godot::Callable size_changed_callable(this, "__on_viewport_size_changed");
+	godot::SubViewport *const viewport = this->_get_viewport();
+	if(viewport && viewport->is_connected("size_changed", size_changed_callable))
+		viewport->disconnect("size_changed", size_changed_callable);
+
+	this->_viewport_id = 0;
+}
+
+void TsvViewportSender::_update_sender_texture(godot::SubViewport *viewport)
+{
+	godot::Ref<godot::ViewportTexture> texture = viewport->get_texture();
+	if(texture.is_null())
+		return;
+
+	// Derived from the viewport settings, reading back the texture would stall the GPU
+	const godot::Image::Format format = this->_get_viewport_format();
+
+	// Also invalidates the sender's cached native handle
+	this->_sender->set_texture(texture, format);
+	this->_texture_dirty = false;
+
+	this->_msaa_2d        = viewport->get_msaa_2d();
+	this->_msaa_3d        = viewport->get_msaa_3d();
+	this->_transparent_bg = viewport->has_transparent_background();
+}
+
+godot::Image::Format TsvViewportSender::_get_viewport_format() const
+{
+	// Godot 4.1 creates all viewport render targets as R8G8B8A8_UNORM. A transparent background only changes the clear
+	// color's alpha
+	return godot::Image::FORMAT_RGBA8;
+}
+
+bool TsvViewportSender::_render_target_changed(const godot::SubViewport *viewport) const
+{
+	// Changing these recreates the render target without resizing it
+	return viewport->get_msaa_2d() != this->_msaa_2d || viewport->get_msaa_3d() != this->_msaa_3d ||
+	       viewport->has_transparent_background() != this->_transparent_bg;
+}
+
+bool TsvViewportSender::_viewport_rendered(const godot::SubViewport *viewport)
+{
+	const godot::SubViewport::UpdateMode update_mode   = viewport->get_update_mode();
+	const godot::SubViewport::UpdateMode previous_mode = this->_update_mode;
+	this->_update_mode                                 = update_mode;
+
+	if(update_mode == godot::SubViewport::UPDATE_DISABLED)
+		return false;
+	else if(update_mode == godot::SubViewport::UPDATE_ONCE)
+	{
+		// Rendered in the frame the mode was set, afterwards the viewport keeps reporting UPDATE_ONCE without drawing.
+		// Setting UPDATE_ONCE again can't be detected, call refresh() to send the new render
+		return previous_mode != godot::SubViewport::UPDATE_ONCE;
+	}
+	else if(update_mode == godot::SubViewport::UPDATE_WHEN_PARENT_VISIBLE)
+	{
+		const godot::CanvasItem *const parent = godot::Object::cast_to<godot::CanvasItem>(viewport->get_parent());
+		return !parent || parent->is_visible_in_tree();
+	}
+	else if(update_mode == godot::SubViewport::UPDATE_WHEN_VISIBLE)
+	{
+		// Only rendered while the texture is displayed. A SubViewportContainer parent is the only display that can be
+		// checked, other users of the texture (e.g. a TextureRect) are assumed to be visible
+		const godot::SubViewportContainer *const container =
+			godot::Object::cast_to<godot::SubViewportContainer>(viewport->get_parent());
+		return !container || container->is_visible_in_tree();
+	}
+
+	// UPDATE_ALWAYS
+	return true;
+}
+
+void TsvViewportSender::_on_viewport_size_changed()
+{
+	// The render target is recreated, look up the texture after it has been drawn
+	this->_texture_dirty = true;
+}
+
+void TsvViewportSender::_on_frame_post_draw()
+{
+	godot::SubViewport *const viewport = this->_get_viewport();
+	if(!viewport)
+	{
+		// Viewport was freed, stop sending its texture
+		this->_detach_viewport();
+		this->_sender->set_texture(godot::Ref<godot::Texture2D>(), godot::Image::FORMAT_RGBA8);
+		return;
+	}
+
+	if(this->_texture_dirty || this->_render_target_changed(viewport))
+		this->_update_sender_texture(viewport);
+
+	if(this->_viewport_rendered(viewport))
+		this->_sender->mark_texture_changed();
+
+	this->_sender->send_texture();
+}
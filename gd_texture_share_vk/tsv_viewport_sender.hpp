@@ -0,0 +1,84 @@
+#pragma once
+
+#include <gdextension_interface.h>
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/classes/sub_viewport.hpp>
+
+#include "tsv_sender.hpp"
+
+/*! \brief Send a SubViewport's texture to other processes
+ *
+ * Attach as a child of a SubViewport, or set viewport_path. The texture format is derived from the viewport settings,
+ * and the texture's native handle is only looked up again when the viewport is resized or its render target settings
+ * change.
+ */
+class TsvViewportSender : public godot::Node
+{
+	GDCLASS(TsvViewportSender, godot::Node);
+
+	public:
+	TsvViewportSender();
+	~TsvViewportSender() override;
+
+	/*! \brief Get the path to the shared SubViewport
+	 */
+	godot::NodePath get_viewport_path() const;
+
+	/*! \brief Set the path to the shared SubViewport. If empty, the parent node is used
+	 */
+	void set_viewport_path(const godot::NodePath &viewport_path);
+
+	/*! \brief Get the share channel name
+	 */
+	godot::String get_shared_texture_name() const;
+
+	/*! \brief Set the share channel name
+	 */
+	void set_shared_texture_name(const godot::String &shared_texture_name);
+
+	/*! \brief Get the underlying TsvSender, e.g. to set source_rect or transfer_priority
+	 */
+	godot::Ref<TsvSender> get_sender() const;
+
+	/*! \brief Look up the viewport's texture and format again and send it on the next frame. Required if the viewport's
+	 * render target was recreated for reasons other than resizing or changing MSAA or transparency, or after setting
+	 * UPDATE_ONCE while the viewport already was in that mode
+	 */
+	void refresh();
+
+	void _notification(int what);
+
+	protected:
+	static void _bind_methods();
+
+	private:
+	godot::Ref<TsvSender> _sender;
+	godot::NodePath       _viewport_path;
+
+	// The viewport may be freed independently of this node, so it's looked up by ID
+	uint64_t _viewport_id = 0;
+
+	bool _texture_dirty = true;
+
+	// Render target settings at the last texture lookup
+	godot::Viewport::MSAA _msaa_2d        = godot::Viewport::MSAA_DISABLED;
+	godot::Viewport::MSAA _msaa_3d        = godot::Viewport::MSAA_DISABLED;
+	bool                  _transparent_bg = false;
+
+	// Update mode in the last frame, to detect the single render of UPDATE_ONCE
+	godot::SubViewport::UpdateMode _update_mode = godot::SubViewport::UPDATE_WHEN_VISIBLE;
+
+	godot::SubViewport *_get_viewport() const;
+
+	void _attach_viewport();
+	void _detach_viewport();
+	void _update_sender_texture(godot::SubViewport *viewport);
+
+	godot::Image::Format _get_viewport_format() const;
+
+	bool _render_target_changed(const godot::SubViewport *viewport) const;
+	bool _viewport_rendered(const godot::SubViewport *viewport);
+
+	void _on_viewport_size_changed();
+	void _on_frame_post_draw();
+};